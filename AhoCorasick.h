@@ -0,0 +1,640 @@
+#pragma once
+#include "bits/stdc++.h"
+#include "MappedImage.h"
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+struct AhoCorasick {
+    static const int BYTES = 256;
+
+    // Build-time trie node, discarded by build()
+    struct Node {
+        vector<int> next;          // trie edges, indexed by byte class
+        int link = -1;             // suffix link
+        int out_link = -1;         // nearest terminal link
+        vector<int> out;           // pattern indices ending here
+        int p = -1;                // parent
+        char pch;                  // char from parentc
+
+        Node(int parent = -1, char ch = '$') : p(parent), pch(ch) {}
+    };
+
+    vector<Node> t;                // trie, only alive between construction and build()
+    array<int, BYTES> cls{};       // byte -> class, 0 = byte not used by any pattern
+    int K = 1;                     // number of byte classes
+    int max_len = 0;               // longest pattern, bounds the overlap between segments
+    int num_patterns = 0;          // 1 + largest pattern id
+
+    // Frozen automaton, filled by build()
+    int states = 0;
+    Table<int32_t> delta;          // delta[v * K + c] = go(v, c)
+    Table<int32_t> out_begin;      // CSR: pattern ids of v are out_ids[out_begin[v] .. out_begin[v+1])
+    Table<int32_t> out_ids;
+    Table<int32_t> out_link;       // nearest non-root state on the suffix-link chain with outputs, -1 if none
+    Table<int32_t> chain_out;      // number of pattern ids on the whole out_link chain of v (root: its own)
+    Table<unsigned char> bad;      // state or one of its suffixes ends a pattern
+    shared_ptr<void> image;        // keeps a loaded file mapped while any copy uses it
+
+    // Prefilter: while at the root, jump straight to the next byte that starts some pattern
+    bool use_prefilter = true;     // knob, the scan result is the same either way
+    bool prefilter_ok = false;     // root has no outputs and few enough leading bytes
+    array<unsigned char, BYTES> is_start{};
+    int n_starts = 0;
+    array<unsigned char, 3> start_bytes{};
+    array<unsigned char, 16> lo_nib{}, hi_nib{}; // shufti tables, see init_prefilter
+
+    AhoCorasick() { t.emplace_back(); }
+
+    // Only valid before build() or load(); throws logic_error afterwards
+    void add_string(const string &s, int id) {
+        if (t.empty()) throw logic_error("AhoCorasick: add_string after build() or load()");
+        int v = 0;
+        for (char ch : s) {
+            int &c = cls[(unsigned char)ch];
+            if (c == 0) c = K++;   // first time this byte shows up
+            if ((int)t[v].next.size() <= c) t[v].next.resize(c + 1, -1);
+            if (t[v].next[c] == -1) {
+                t[v].next[c] = t.size();
+                t.emplace_back(v, ch);
+            }
+            v = t[v].next[c];
+        }
+        t[v].out.push_back(id);
+        max_len = max(max_len, (int)s.size());
+        num_patterns = max(num_patterns, id + 1);
+    }
+
+    // Freeze the trie; throws logic_error if it was already built or loaded
+    void build() {
+        if (t.empty()) throw logic_error("AhoCorasick: build() called twice or after load()");
+        auto &delta = this->delta.own, &out_begin = this->out_begin.own, &out_ids = this->out_ids.own;
+        auto &out_link = this->out_link.own, &chain_out = this->chain_out.own;
+        auto &bad = this->bad.own;
+
+        states = t.size();
+        for (auto &nd : t) nd.next.resize(K, -1);
+        delta.assign((size_t)states * K, -1);
+        bad.assign(states, 0);
+        chain_out.assign(states, 0);
+        chain_out[0] = t[0].out.size();
+
+        queue<int> q;
+        t[0].link = 0;
+        for (int c = 0; c < K; c++) {
+            int u = t[0].next[c];
+            if (u != -1) {
+                t[u].link = 0;
+                chain_out[u] = t[u].out.size();
+                q.push(u);
+            }
+            delta[c] = (u == -1 ? 0 : u); // initialize go transitions for root
+        }
+
+        while (!q.empty()) {
+            int v = q.front(); q.pop();
+            bad[v] = (!t[v].out.empty()) || bad[t[v].link]; // mark forbidden
+            int32_t *row = &delta[(size_t)v * K];
+            const int32_t *lrow = &delta[(size_t)t[v].link * K];
+            for (int c = 0; c < K; c++) {
+                int u = t[v].next[c];
+                if (u != -1) {
+                    // compute suffix link of u
+                    t[u].link = lrow[c];
+                    // merge outputs; the root's (empty patterns) only count while at the root
+                    int w = t[u].link;
+                    t[u].out_link = w != 0 && !t[w].out.empty() ? w : t[w].out_link;
+                    chain_out[u] = t[u].out.size() + (w != 0 ? chain_out[w] : 0);
+                    q.push(u);
+                }
+                // always fill go transition
+                row[c] = (u != -1 ? u : lrow[c]);
+            }
+        }
+
+        out_begin.assign(states + 1, 0);
+        out_link.resize(states);
+        for (int v = 0; v < states; v++) {
+            out_begin[v + 1] = out_begin[v] + t[v].out.size();
+            out_link[v] = t[v].out_link;
+        }
+        out_ids.clear();
+        out_ids.reserve(out_begin[states]);
+        for (auto &nd : t) out_ids.insert(out_ids.end(), nd.out.begin(), nd.out.end());
+
+        vector<Node>().swap(t);    // drop build-only data
+        for (auto *tb : {&this->delta, &this->out_begin, &this->out_ids, &this->out_link, &this->chain_out})
+            tb->bind();
+        this->bad.bind();
+        init_prefilter();
+    }
+
+    // Leading bytes are the ones leaving the root. For SIMD, up to 3 of them are compared
+    // directly; larger sets use shufti: byte b may start a pattern iff
+    // lo_nib[b & 15] & hi_nib[b >> 4] != 0 (false positives only cost a root step).
+    void init_prefilter() {
+        is_start.fill(0);
+        lo_nib.fill(0);
+        hi_nib.fill(0);
+        n_starts = 0;
+        for (int b = 0; b < BYTES; b++) {
+            if (cls[b] == 0 || delta[cls[b]] == 0) continue;
+            is_start[b] = 1;
+            if (n_starts < 3) start_bytes[n_starts] = b;
+            n_starts++;
+            unsigned char bit = 1 << ((b >> 4) & 7);
+            lo_nib[b & 15] |= bit;
+            hi_nib[b >> 4] = bit;
+        }
+        prefilter_ok = out_begin[1] == out_begin[0] && n_starts < BYTES / 2;
+    }
+
+    // first j in [i, n) where s[j] may start a pattern, n if none
+    size_t skip_to_start(const char *s, size_t i, size_t n) const {
+#if defined(__AVX2__)
+        if (n_starts <= 3) {
+            __m256i c0 = _mm256_set1_epi8(start_bytes[0]);
+            __m256i c1 = _mm256_set1_epi8(start_bytes[n_starts > 1 ? 1 : 0]);
+            __m256i c2 = _mm256_set1_epi8(start_bytes[n_starts > 2 ? 2 : 0]);
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+                __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi8(x, c0),
+                             _mm256_or_si256(_mm256_cmpeq_epi8(x, c1), _mm256_cmpeq_epi8(x, c2)));
+                unsigned m = _mm256_movemask_epi8(eq);
+                if (m) return i + __builtin_ctz(m);
+            }
+        } else {
+            __m128i lo128 = _mm_loadu_si128((const __m128i *)lo_nib.data());
+            __m128i hi128 = _mm_loadu_si128((const __m128i *)hi_nib.data());
+            __m256i lo = _mm256_broadcastsi128_si256(lo128), hi = _mm256_broadcastsi128_si256(hi128);
+            __m256i low4 = _mm256_set1_epi8(0x0f), zero = _mm256_setzero_si256();
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+                __m256i a = _mm256_shuffle_epi8(lo, _mm256_and_si256(x, low4));
+                __m256i b = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(x, 4), low4));
+                unsigned m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(a, b), zero));
+                if (m) return i + __builtin_ctz(m);
+            }
+        }
+#elif defined(__SSE2__)
+        if (n_starts <= 3) {
+            __m128i c0 = _mm_set1_epi8(start_bytes[0]);
+            __m128i c1 = _mm_set1_epi8(start_bytes[n_starts > 1 ? 1 : 0]);
+            __m128i c2 = _mm_set1_epi8(start_bytes[n_starts > 2 ? 2 : 0]);
+            for (; i + 16 <= n; i += 16) {
+                __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+                __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(x, c0),
+                             _mm_or_si128(_mm_cmpeq_epi8(x, c1), _mm_cmpeq_epi8(x, c2)));
+                unsigned m = _mm_movemask_epi8(eq);
+                if (m) return i + __builtin_ctz(m);
+            }
+        }
+#if defined(__SSSE3__)
+        else {
+            __m128i lo = _mm_loadu_si128((const __m128i *)lo_nib.data());
+            __m128i hi = _mm_loadu_si128((const __m128i *)hi_nib.data());
+            __m128i low4 = _mm_set1_epi8(0x0f), zero = _mm_setzero_si128();
+            for (; i + 16 <= n; i += 16) {
+                __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+                __m128i a = _mm_shuffle_epi8(lo, _mm_and_si128(x, low4));
+                __m128i b = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(x, 4), low4));
+                unsigned m = 0xffffu & ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(a, b), zero));
+                if (m) return i + __builtin_ctz(m);
+            }
+        }
+#endif
+#endif
+        while (i < n && !is_start[(unsigned char)s[i]]) i++;
+        return i;
+    }
+
+    // Image file (see MappedImage.h): header, then the sections below in order
+    struct ImageHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t K, states, max_len, num_patterns, total_out;
+        uint64_t file_size;
+    };
+    static constexpr char IMAGE_MAGIC[8] = {'A', 'C', 'I', 'M', 'A', 'G', 'E', 0};
+    static const uint32_t IMAGE_VERSION = 3;
+
+    // {offset, bytes} of every section for the given header
+    static Image::Layout image_sections(const ImageHeader &h) {
+        return Image::layout(sizeof(ImageHeader), {
+            sizeof(int32_t) * BYTES,                    // cls
+            sizeof(int32_t) * (size_t)h.states * h.K,   // delta
+            sizeof(int32_t) * ((size_t)h.states + 1),   // out_begin
+            sizeof(int32_t) * (size_t)h.total_out,      // out_ids
+            sizeof(int32_t) * (size_t)h.states,         // out_link
+            sizeof(int32_t) * (size_t)h.states,         // chain_out
+            (size_t)h.states,                           // bad
+        });
+    }
+
+    // Write the built automaton to path; false on I/O error
+    bool save(const string &path) const {
+        ImageHeader h{};
+        memcpy(h.magic, IMAGE_MAGIC, 8);
+        h.version = IMAGE_VERSION;
+        h.K = K; h.states = states; h.max_len = max_len;
+        h.num_patterns = num_patterns; h.total_out = out_ids.size();
+        auto sec = image_sections(h);
+        h.file_size = Image::file_size(sec);
+
+        array<int32_t, BYTES> cls32;
+        for (int b = 0; b < BYTES; b++) cls32[b] = cls[b];
+        return Image::write(path, h, sec, {cls32.data(), delta.ptr, out_begin.ptr, out_ids.ptr,
+                                           out_link.ptr, chain_out.ptr, bad.ptr});
+    }
+
+    // Map an image written by save(); queries read the mapped pages directly.
+    // false if the file is missing, truncated, inconsistent or from another format version.
+    bool load(const string &path) {
+        size_t size = 0;
+        shared_ptr<void> map = Image::map_file(path, sizeof(ImageHeader), size);
+        if (!map) return false;
+
+        ImageHeader h;
+        memcpy(&h, map.get(), sizeof(h));
+        if (memcmp(h.magic, IMAGE_MAGIC, 8) != 0 || h.version != IMAGE_VERSION || h.file_size != size)
+            return false;
+        if (h.K <= 0 || h.K > BYTES || h.states <= 0 || h.total_out < 0) return false;
+        auto sec = image_sections(h);
+        if (!Image::fits(sec, size)) return false;
+        const char *base = (const char *)map.get();
+        auto at = [&](int i) { return base + sec[i].first; };
+
+        const int32_t *cls32 = (const int32_t *)at(0);
+        for (int b = 0; b < BYTES; b++)
+            if (cls32[b] < 0 || cls32[b] >= h.K) return false;
+        for (int b = 0; b < BYTES; b++) cls[b] = cls32[b];
+        K = h.K; states = h.states; max_len = h.max_len; num_patterns = h.num_patterns;
+        delta.view((const int32_t *)at(1), (size_t)states * K);
+        out_begin.view((const int32_t *)at(2), states + 1);
+        out_ids.view((const int32_t *)at(3), h.total_out);
+        out_link.view((const int32_t *)at(4), states);
+        chain_out.view((const int32_t *)at(5), states);
+        bad.view((const unsigned char *)at(6), states);
+        vector<Node>().swap(t);
+        image = move(map);
+        init_prefilter();
+        return true;
+    }
+
+    int go(int v, char ch) const {
+        return delta[(size_t)v * K + cls[(unsigned char)ch]];
+    }
+
+    // {pattern_id, ending_position}; positions are 64-bit so texts above 2 GiB work
+    using Match = pair<int, long long>;
+
+    // f(pattern_id, ending_position) for every match, nothing is stored
+    template<class F>
+    void for_each_match(const string &text, F &&f) const {
+        const size_t n = text.size();
+        const bool skip = use_prefilter && prefilter_ok;
+        int v = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (v == 0 && skip && (i = skip_to_start(text.data(), i, n)) == n) break;
+            v = go(v, text[i]);
+            for (int u = v; u != -1; u = out_link[u]) {
+                for (int k = out_begin[u]; k < out_begin[u + 1]; k++) {
+                    f(out_ids[k], (long long)i);
+                }
+            }
+        }
+    }
+
+    // returns {pattern_id, ending_position}
+    vector<Match> find_all(const string &text) const {
+        vector<Match> res;
+        for_each_match(text, [&](int id, long long i) { res.emplace_back(id, i); });
+        return res;
+    }
+
+    // total number of matches, one table lookup per byte
+    long long count_matches(const string &text) const {
+        const size_t n = text.size();
+        const bool skip = use_prefilter && prefilter_ok;
+        long long cnt = 0;
+        int v = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (v == 0 && skip && (i = skip_to_start(text.data(), i, n)) == n) break;
+            v = go(v, text[i]);
+            cnt += chain_out[v];
+        }
+        return cnt;
+    }
+
+    // Marks reused across patterns_seen calls. done grows to the largest automaton scanned
+    // and only the states a scan marked are cleared afterwards, so once warm a scan costs
+    // O(|text|) plus the num_patterns bits of its result, not O(states).
+    struct SeenScratch {
+        vector<unsigned char> done;
+        vector<int> marked;
+    };
+
+    // seen[id] = pattern id occurs somewhere in text.
+    // A visited state has its whole out_link chain marked already, so the walk stops there.
+    vector<bool> patterns_seen(const string &text, SeenScratch &scratch) const {
+        vector<bool> seen(num_patterns, false);
+        if (scratch.done.size() < (size_t)states) scratch.done.resize(states, 0);
+        auto &done = scratch.done;
+        auto &marked = scratch.marked;
+        const size_t n = text.size();
+        const bool skip = use_prefilter && prefilter_ok;
+        int v = 0, left = out_begin[states];
+        for (size_t i = 0; i < n && left > 0; i++) {
+            if (v == 0 && skip && (i = skip_to_start(text.data(), i, n)) == n) break;
+            v = go(v, text[i]);
+            for (int u = v; u != -1 && !done[u]; u = out_link[u]) {
+                done[u] = 1;
+                marked.push_back(u);
+                for (int k = out_begin[u]; k < out_begin[u + 1]; k++) {
+                    seen[out_ids[k]] = true;
+                    left--;
+                }
+            }
+        }
+        for (int u : marked) done[u] = 0;
+        marked.clear();
+        return seen;
+    }
+
+    // Same, with scratch kept per thread
+    vector<bool> patterns_seen(const string &text) const {
+        thread_local SeenScratch scratch;
+        return patterns_seen(text, scratch);
+    }
+
+    // Many independent documents against one automaton. LANES documents advance in
+    // lockstep and the next transition cell of each is prefetched, so the cache misses
+    // of different documents overlap instead of serialising one scan.
+    // f(doc_index, pattern_id, ending_position)
+    template<class F>
+    void for_each_match_batch(const vector<string> &docs, F &&f) const {
+        const int LANES = 16;
+        int doc[LANES], st[LANES];
+        const char *p[LANES], *e[LANES];
+        size_t next_doc = 0;
+        int active = 0;
+
+        auto refill = [&](int l) {
+            doc[l] = -1;
+            while (next_doc < docs.size() && doc[l] == -1) {
+                const string &d = docs[next_doc];
+                if (!d.empty()) {
+                    doc[l] = next_doc;
+                    st[l] = 0;
+                    p[l] = d.data();
+                    e[l] = d.data() + d.size();
+                }
+                next_doc++;
+            }
+            if (doc[l] != -1) active++;
+        };
+        for (int l = 0; l < LANES; l++) refill(l);
+
+        while (active > 0) {
+            for (int l = 0; l < LANES; l++) {
+                if (doc[l] == -1) continue;
+                int v = go(st[l], *p[l]);
+                if (p[l] + 1 < e[l])
+                    __builtin_prefetch(&delta[(size_t)v * K + cls[(unsigned char)p[l][1]]]);
+                long long pos = p[l] - docs[doc[l]].data();
+                for (int u = v; u != -1; u = out_link[u])
+                    for (int k = out_begin[u]; k < out_begin[u + 1]; k++)
+                        f(doc[l], out_ids[k], pos);
+                st[l] = v;
+                if (++p[l] == e[l]) {
+                    active--;
+                    refill(l);
+                }
+            }
+        }
+    }
+
+    // res[doc] = find_all(docs[doc])
+    vector<vector<Match>> find_all_batch(const vector<string> &docs) const {
+        vector<vector<Match>> res(docs.size());
+        for_each_match_batch(docs, [&](int d, int id, long long i) { res[d].emplace_back(id, i); });
+        return res;
+    }
+
+    // Same result as find_all, text split into one segment per thread.
+    // Each thread starts max_len - 1 bytes before its segment to rebuild the state
+    // and only reports matches ending inside its own segment, so overlaps never repeat.
+    vector<Match> find_all_parallel(const string &text, int threads = 0) const {
+        const size_t n = text.size();
+        if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+        const size_t MIN_SEGMENT = 1 << 16;
+        threads = (int)max<size_t>(1, min<size_t>(threads, n / max<size_t>(MIN_SEGMENT, max_len)));
+        if (threads == 1) return find_all(text);
+
+        vector<vector<Match>> part(threads);
+        vector<thread> pool;
+        for (int k = 0; k < threads; k++) {
+            pool.emplace_back([&, k] {
+                size_t lo = n * k / threads, hi = n * (k + 1) / threads;
+                const bool skip = use_prefilter && prefilter_ok;
+                int v = 0;
+                for (size_t i = lo >= (size_t)max_len ? lo - max_len + 1 : 0; i < hi; i++) {
+                    if (v == 0 && skip && (i = skip_to_start(text.data(), i, hi)) == hi) break;
+                    v = go(v, text[i]);
+                    if (i < lo) continue;
+                    for (int u = v; u != -1; u = out_link[u])
+                        for (int j = out_begin[u]; j < out_begin[u + 1]; j++)
+                            part[k].emplace_back(out_ids[j], (long long)i);
+                }
+            });
+        }
+        for (auto &th : pool) th.join();
+
+        size_t total = 0;
+        for (auto &p : part) total += p.size();
+        vector<Match> res;
+        res.reserve(total);
+        for (auto &p : part) res.insert(res.end(), p.begin(), p.end());
+        return res;
+    }
+
+    // Resumable scan: feed the text in chunks of any size, state carries over
+    // so matches crossing chunk boundaries are reported with global positions.
+    struct Scanner {
+        const AhoCorasick *ac;
+        int state = 0;          // automaton state after the last fed byte
+        long long offset = 0;   // global position of the next byte
+
+        explicit Scanner(const AhoCorasick &a) : ac(&a) {}
+
+        void reset() { state = 0; offset = 0; }
+
+        // f(pattern_id, ending_position) for every match ending inside the chunk
+        template<class F>
+        void feed(const char *data, size_t len, F &&f) {
+            int v = state;
+            for (size_t i = 0; i < len; i++) {
+                v = ac->go(v, data[i]);
+                for (int u = v; u != -1; u = ac->out_link[u])
+                    for (int k = ac->out_begin[u]; k < ac->out_begin[u + 1]; k++)
+                        f(ac->out_ids[k], offset + (long long)i);
+            }
+            state = v;
+            offset += (long long)len;
+        }
+
+        template<class F>
+        void feed(const string &chunk, F &&f) { feed(chunk.data(), chunk.size(), f); }
+    };
+
+    Scanner scanner() const { return Scanner(*this); }
+
+    string lexicographically_smallest(AhoCorasick &ac, int L) {
+        string res;
+        int v = 0; // start at root
+        for (int i = 0; i < L; i++) {
+            for (char ch = 'a'; ch <= 'z'; ch++) {
+                int u = ac.go(v, ch);
+                if (!ac.bad[u]) { // avoid forbidden states
+                    res.push_back(ch);
+                    v = u;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+};
+
+// Online insertions without rebuilding everything: patterns live in a logarithmic set of
+// frozen automata, level i holding 2^i patterns (binary counter). A new pattern carries the
+// full levels below the first empty one into it, so each pattern is rebuilt O(log n) times
+// overall. Merges of fewer than BACKGROUND_MIN patterns are built on the spot. Larger ones
+// are built on a worker thread; until that finishes the level answers queries through the
+// automata it was merged from plus a one-pattern automaton for the new string. So an insert
+// costs O(|s| + log n) on the calling thread, plus at most BACKGROUND_MIN patterns' worth of
+// building. Finished merges are installed by collect(), which add_string calls first.
+// Queries fan out over the automata of every level. The destructor waits for running merges.
+struct DynamicAhoCorasick {
+    using Patterns = vector<pair<string,int>>;
+    static const size_t BACKGROUND_MIN = 1 << 12;
+
+    struct Built {
+        shared_ptr<const Patterns> patterns;
+        shared_ptr<const AhoCorasick> ac;
+    };
+
+    struct Level {
+        size_t count = 0;                             // patterns held, 0 = empty level
+        vector<shared_ptr<const Patterns>> sources;   // its patterns, one list once merged
+        vector<shared_ptr<const AhoCorasick>> parts;  // automata answering for the level
+        future<Built> building;                       // background merge, valid while pending
+    };
+
+    vector<Level> levels;
+    vector<future<Built>> retired; // merges whose level was carried on before they finished
+    int num_patterns = 0;          // 1 + largest pattern id
+
+    static Built merge(const vector<shared_ptr<const Patterns>> &sources) {
+        auto all = make_shared<Patterns>();
+        for (auto &p : sources) all->insert(all->end(), p->begin(), p->end());
+        auto ac = make_shared<AhoCorasick>();
+        for (auto &[str, pid] : *all) ac->add_string(str, pid);
+        ac->build();
+        return {all, ac};
+    }
+
+    static bool ready(const future<Built> &f) {
+        return f.wait_for(chrono::seconds(0)) == future_status::ready;
+    }
+
+    // Install background merges that have finished; never blocks
+    void collect() {
+        for (auto &lv : levels) {
+            if (!lv.building.valid() || !ready(lv.building)) continue;
+            Built b = lv.building.get();
+            lv.sources = {b.patterns};
+            lv.parts = {b.ac};
+        }
+        retired.erase(remove_if(retired.begin(), retired.end(), ready), retired.end());
+    }
+
+    // Block until every background merge is installed
+    void wait() {
+        for (auto &lv : levels) {
+            if (!lv.building.valid()) continue;
+            Built b = lv.building.get();
+            lv.sources = {b.patterns};
+            lv.parts = {b.ac};
+        }
+        retired.clear();
+    }
+
+    void add_string(const string &s, int id) {
+        collect();
+        auto one = make_shared<const Patterns>(Patterns{{s, id}});
+        Level carry;
+        carry.count = 1;
+        carry.sources = {one};
+        size_t i = 0;
+        for (; i < levels.size() && levels[i].count; i++) {
+            Level &lv = levels[i];
+            carry.count += lv.count;
+            carry.sources.insert(carry.sources.end(), lv.sources.begin(), lv.sources.end());
+            carry.parts.insert(carry.parts.end(), lv.parts.begin(), lv.parts.end());
+            if (lv.building.valid()) retired.push_back(move(lv.building));
+            lv = Level();
+        }
+        if (i == levels.size()) levels.emplace_back();
+        if (carry.count < BACKGROUND_MIN) {
+            Built b = merge(carry.sources);
+            carry.sources = {b.patterns};
+            carry.parts = {b.ac};
+        } else {
+            carry.parts.push_back(merge({one}).ac);
+            carry.building = async(launch::async, merge, carry.sources);
+        }
+        levels[i] = move(carry);
+        num_patterns = max(num_patterns, id + 1);
+    }
+
+    // returns {pattern_id, ending_position}, ordered by position
+    vector<AhoCorasick::Match> find_all(const string &text) const {
+        vector<AhoCorasick::Match> res;
+        for (auto &lv : levels) {
+            for (auto &ac : lv.parts) {
+                size_t mid = res.size();
+                ac->for_each_match(text, [&](int id, long long i) { res.emplace_back(id, i); });
+                inplace_merge(res.begin(), res.begin() + mid, res.end(),
+                              [](const AhoCorasick::Match &a, const AhoCorasick::Match &b) { return a.second < b.second; });
+            }
+        }
+        return res;
+    }
+
+    long long count_matches(const string &text) const {
+        long long cnt = 0;
+        for (auto &lv : levels)
+            for (auto &ac : lv.parts) cnt += ac->count_matches(text);
+        return cnt;
+    }
+
+    vector<bool> patterns_seen(const string &text, AhoCorasick::SeenScratch &scratch) const {
+        vector<bool> seen(num_patterns, false);
+        for (auto &lv : levels) {
+            for (auto &ac : lv.parts) {
+                auto part = ac->patterns_seen(text, scratch);
+                for (size_t id = 0; id < part.size(); id++)
+                    if (part[id]) seen[id] = true;
+            }
+        }
+        return seen;
+    }
+
+    vector<bool> patterns_seen(const string &text) const {
+        thread_local AhoCorasick::SeenScratch scratch;
+        return patterns_seen(text, scratch);
+    }
+};
@@ -0,0 +1,117 @@
+#include "AhoCorasick.h"
+#include "BenchUtil.h"
+
+// Synthetic benchmark for AhoCorasick, one JSON object per configuration on stdout.
+//
+//   AhoCorasickBench [text_mb=64] [threads=0] [seed=1]
+//
+// Dictionaries vary in pattern count, length range and alphabet skew. Pattern symbols are
+// drawn from a Zipf(skew) distribution over `alphabet` bytes (skew 0 = uniform), text symbols
+// from the same distribution over `text_alphabet` bytes; a wider text alphabet gives the
+// sparse, low-hit-rate text the prefilter targets. A few dictionary patterns are planted in
+// the text so matches always occur. Each configuration runs in its own child process, so
+// peak_rss_kb is that configuration's high-water mark rather than the largest one so far.
+
+struct BenchConfig {
+    int patterns;
+    int min_len, max_len;
+    int alphabet;
+    double skew;
+    int text_alphabet;
+};
+
+struct ZipfBytes {
+    vector<double> cdf;
+    explicit ZipfBytes(int alphabet, double skew) {
+        double sum = 0;
+        for (int i = 1; i <= alphabet; i++) cdf.push_back(sum += 1.0 / pow(i, skew));
+        for (double &x : cdf) x /= sum;
+    }
+    char operator()(mt19937_64 &rng) const {
+        double u = uniform_real_distribution<double>(0, 1)(rng);
+        int k = lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        return 'a' + min(k, (int)cdf.size() - 1);
+    }
+};
+
+static void run(const BenchConfig &cfg, size_t text_bytes, int threads, uint64_t seed) {
+    mt19937_64 rng(seed);
+    ZipfBytes sym(cfg.alphabet, cfg.skew), text_sym(cfg.text_alphabet, cfg.skew);
+
+    vector<string> dict(cfg.patterns);
+    for (auto &p : dict) {
+        int len = uniform_int_distribution<int>(cfg.min_len, cfg.max_len)(rng);
+        for (int i = 0; i < len; i++) p += sym(rng);
+    }
+    string text(text_bytes, 0);
+    for (char &c : text) c = text_sym(rng);
+    for (int k = 0; k < 1000 && !dict.empty(); k++) {
+        const string &p = dict[rng() % dict.size()];
+        size_t at = rng() % (text.size() - min(text.size(), p.size()) + 1);
+        text.replace(at, min(p.size(), text.size() - at), p, 0, min(p.size(), text.size() - at));
+    }
+
+    AhoCorasick ac;
+    double build_ms = time_ms([&] {
+        for (int i = 0; i < (int)dict.size(); i++) ac.add_string(dict[i], i);
+        ac.build();
+    });
+    size_t table_bytes = ac.delta.size() * 4 + ac.out_begin.size() * 4 + ac.out_ids.size() * 4
+                       + ac.out_link.size() * 4 + ac.chain_out.size() * 4 + ac.bad.size();
+
+    double mb = text.size() / 1e6;
+    vector<string> rows;
+    auto row = [&](const char *mode, double ms, long long matches) {
+        char buf[256];
+        snprintf(buf, sizeof buf,
+                 "{\"mode\": \"%s\", \"ms\": %.3f, \"mb_per_s\": %.2f, \"matches\": %lld, \"matches_per_s\": %.0f}",
+                 mode, ms, mb / (ms / 1e3), matches, matches / (ms / 1e3));
+        rows.push_back(buf);
+    };
+
+    long long matches = 0;
+    for (bool pre : {false, true}) {
+        ac.use_prefilter = pre;
+        double ms = time_ms([&] { matches = 0; ac.for_each_match(text, [&](int, long long) { matches++; }); });
+        row(pre ? "for_each_match+prefilter" : "for_each_match", ms, matches);
+    }
+    double ms = time_ms([&] { matches = ac.count_matches(text); });
+    row("count_matches", ms, matches);
+    ms = time_ms([&] { auto seen = ac.patterns_seen(text); matches = count(seen.begin(), seen.end(), true); });
+    row("patterns_seen", ms, matches);
+    ms = time_ms([&] { matches = ac.find_all_parallel(text, threads).size(); });
+    row("find_all_parallel", ms, matches);
+
+    vector<string> docs;
+    for (size_t at = 0; at < text.size(); at += 256) docs.push_back(text.substr(at, 256));
+    ms = time_ms([&] { matches = 0; ac.for_each_match_batch(docs, [&](int, int, long long) { matches++; }); });
+    row("batch_256b_docs", ms, matches);
+
+    printf("{\"patterns\": %d, \"min_len\": %d, \"max_len\": %d, \"alphabet\": %d, \"skew\": %.2f, "
+           "\"text_alphabet\": %d, \"text_bytes\": %zu, \"states\": %d, \"classes\": %d, \"build_ms\": %.3f, "
+           "\"table_bytes\": %zu, \"peak_rss_kb\": %ld, \"scans\": [",
+           cfg.patterns, cfg.min_len, cfg.max_len, cfg.alphabet, cfg.skew, cfg.text_alphabet, text.size(),
+           ac.states, ac.K, build_ms, table_bytes, peak_rss_kb());
+    for (size_t i = 0; i < rows.size(); i++) printf("%s%s", i ? ", " : "", rows[i].c_str());
+    printf("]}\n");
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    double text_mb = argc > 1 ? atof(argv[1]) : 64;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+
+    vector<BenchConfig> configs;
+    for (int patterns : {1000, 100000})
+        for (auto len : {pair<int,int>{4, 8}, pair<int,int>{8, 32}})
+            for (double skew : {0.0, 1.2})
+                configs.push_back({patterns, len.first, len.second, 26, skew, 26});
+    configs.push_back({10000, 8, 16, 200, 0.0, 200});
+    configs.push_back({1000, 8, 16, 3, 0.0, 200});     // sparse hits, 3 leading bytes
+    configs.push_back({1000, 8, 16, 12, 0.0, 200});    // sparse hits, shufti set
+
+    for (auto &cfg : configs)
+        if (!in_child([&] { run(cfg, (size_t)(text_mb * 1e6), threads, seed); }))
+            fprintf(stderr, "config with %d patterns failed\n", cfg.patterns);
+}
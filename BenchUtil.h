@@ -0,0 +1,38 @@
+#pragma once
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+// Shared helpers of the *Bench programs
+
+// High-water mark of the calling process; run each case through in_child to get its own
+inline long peak_rss_kb() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+template<class F>
+double time_ms(F &&f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// Run f in a forked child and wait for it; false if the fork fails or the child does not
+// exit cleanly. Flush stdout inside f, the child leaves through _exit.
+template<class F>
+bool in_child(F &&f) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        f();
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
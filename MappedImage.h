@@ -0,0 +1,124 @@
+#pragma once
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+// Read-only array: either owns its data (after build) or views a mapped image (after load)
+template<class T>
+struct Table {
+    vector<T> own;
+    const T *ptr = nullptr;
+    size_t len = 0;
+
+    Table() {}
+    Table(const Table &o) { *this = o; }
+    Table(Table &&) = default;
+    Table &operator=(Table &&) = default;
+    Table &operator=(const Table &o) {
+        own = o.own;
+        ptr = own.empty() ? o.ptr : own.data();
+        len = o.len;
+        return *this;
+    }
+    Table &operator=(vector<T> v) { own = move(v); bind(); return *this; }
+
+    void bind() { ptr = own.data(); len = own.size(); }
+    void view(const T *p, size_t n) { vector<T>().swap(own); ptr = p; len = n; }
+    const T &operator[](size_t i) const { return ptr[i]; }
+    const T *data() const { return ptr; }
+    const T *begin() const { return ptr; }
+    const T *end() const { return ptr + len; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+};
+
+// Image files: a fixed header, then sections in order, each starting on an 8-byte boundary;
+// the file ends with the last section padded to 8 bytes. Native byte order, so the same
+// build of the code writes and reads them.
+namespace Image {
+
+    using Layout = vector<pair<size_t,size_t>>;   // {offset, bytes} of every section
+
+    inline size_t pad8(size_t x) { return (x + 7) & ~size_t(7); }
+
+    inline Layout layout(size_t header_bytes, const vector<size_t> &sizes) {
+        Layout sec;
+        size_t off = pad8(header_bytes);
+        for (size_t sz : sizes) {
+            sec.emplace_back(off, sz);
+            off = pad8(off + sz);
+        }
+        return sec;
+    }
+
+    inline size_t file_size(const Layout &sec) { return pad8(sec.back().first + sec.back().second); }
+
+    // Every section lies inside a file of size bytes, and the last one ends it
+    inline bool fits(const Layout &sec, size_t size) {
+        for (auto &[off, len] : sec)
+            if (off > size || len > size - off) return false;
+        return file_size(sec) == size;
+    }
+
+    const uint64_t FNV_BASIS = 1469598103934665603ULL;
+
+    inline uint64_t fnv1a(const uint64_t *w, size_t words, uint64_t h = FNV_BASIS) {
+        for (size_t i = 0; i < words; ++i) h = (h ^ w[i]) * 1099511628211ULL;
+        return h;
+    }
+
+    // Write h and the sections data[i] laid out as sec; false on I/O error. With checksum,
+    // h.*checksum is set to the FNV-1a hash of every 64-bit word after the header.
+    template<class Header>
+    bool write(const string &path, Header h, const Layout &sec, const vector<const void *> &data,
+               uint64_t Header::*checksum = nullptr) {
+        const size_t CHUNK = 1 << 17;   // words copied, hashed and written at a time
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write((const char *)&h, sizeof(h));
+        out.write(string(pad8(sizeof(h)) - sizeof(h), 0).data(), pad8(sizeof(h)) - sizeof(h));
+        vector<uint64_t> buf;
+        uint64_t sum = FNV_BASIS;
+        for (size_t i = 0; i < sec.size(); ++i) {
+            const char *p = (const char *)data[i];
+            size_t left = sec[i].second, words = pad8(left) / 8;
+            for (size_t w = 0; w < words; w += CHUNK) {
+                size_t cw = min(CHUNK, words - w), bytes = min(cw * 8, left);
+                buf.assign(cw, 0);
+                memcpy(buf.data(), p, bytes);
+                p += bytes;
+                left -= bytes;
+                sum = fnv1a(buf.data(), cw, sum);
+                out.write((const char *)buf.data(), cw * 8);
+            }
+        }
+        if (checksum) {
+            h.*checksum = sum;
+            out.seekp(0);
+            out.write((const char *)&h, sizeof(h));
+        }
+        return (bool)out;
+    }
+
+    // Map path read-only and set size to its length. Null if the file is missing, shorter
+    // than min_bytes or cannot be mapped; the mapping lives until the last copy is dropped.
+    inline shared_ptr<void> map_file(const string &path, size_t min_bytes, size_t &size) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat sb;
+        if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < min_bytes || sb.st_size == 0) {
+            close(fd);
+            return nullptr;
+        }
+        size_t len = sb.st_size;
+        void *addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) return nullptr;
+        size = len;
+        return shared_ptr<void>(addr, [len](void *p) { munmap(p, len); });
+    }
+
+} // namespace Image
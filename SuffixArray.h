@@ -0,0 +1,1138 @@
+#pragma once
+#include <bits/stdc++.h>
+#include "MappedImage.h"
+using namespace std;
+
+/*
+  ============================
+  Suffix Array (SA-IS) Library
+  ============================
+
+  WHAT YOU GET
+  ------------
+  - Suffix array via SA-IS in O(n), in place, optionally multi-threaded
+  - LCP array via Kasai or Phi/PLCP in O(n), optionally kept as a 2n-bit PLCP
+  - RMQ over LCP: sparse table in O(n log n) or block RMQ in O(n)
+  - get_lcp(i, j): LCP of suffixes starting at i and j in O(1)
+  - Pattern search: lower/upper bound, occurrence range, batches of patterns
+  - Repeat mining over a bottom-up LCP-interval traversal
+  - save/load of a memory-mapped index image
+  - FMIndex: compressed BWT index with count and locate
+  - GeneralizedSuffixArray: document collections with document listing
+
+  TWEAKABLE KNOBS
+  ---------------
+  - Index: uint32_t (SuffixArray) below 4 GiB of text, uint64_t (SuffixArray64) above;
+    build() throws length_error when the text does not fit in Index.
+  - WANT_RMQ: if you don't need range LCP queries, you can disable the RMQ to save memory.
+  - RMQ_MODE: SPARSE_TABLE or BLOCK_SPARSE.
+  - LCP_MODE: KASAI, PHI or PHI_COMPRESSED.
+
+  NAMING CONVENTIONS
+  ------------------
+  - text: symbol accessor with a virtual sentinel 0 at position n (see SAIS::ByteText).
+  - sa: suffix array, positions 0..n-1 of suffixes in sorted order.
+  - rankAt[pos]: position of suffix 'pos' in 'sa' (inverse SA).
+  - lcp[i]: LCP(sa[i], sa[i+1]) for i in [0..n-2].
+*/
+
+namespace SAIS {
+
+  // inputs below this size are always handled on one thread
+  static const size_t PARALLEL_MIN = 1 << 16;
+  // SA entries buffered per step of the blocked induced-sort scans
+  static const size_t SCAN_BLOCK = 1 << 18;
+
+  // empty SA slot
+  template<class Index> constexpr Index EMPTY = numeric_limits<Index>::max();
+
+  // Top-level text: bytes shifted to [1..256] with a virtual sentinel 0 at position n,
+  // so the input string is never copied into an integer array
+  struct ByteText {
+    const unsigned char* s;
+    size_t n;
+    size_t operator[](size_t i) const { return i < n ? (size_t)s[i] + 1 : 0; }
+  };
+
+  // length of each piece when [0, n) is cut into `threads` pieces aligned to `align`
+  static size_t piece_size(size_t n, int threads, size_t align) {
+    return ((n + threads - 1) / threads + align - 1) / align * align;
+  }
+
+  // f(lo, hi) on the pieces [k * step, (k + 1) * step) of [0, n), step = piece_size(n, threads, align)
+  template<class F>
+  static void parallel_for(size_t n, int threads, F&& f, size_t align = 1) {
+    if (threads <= 1 || n < PARALLEL_MIN) { f((size_t)0, n); return; }
+    size_t step = piece_size(n, threads, align);
+    vector<thread> pool;
+    for (size_t lo = 0; lo < n; lo += step)
+      pool.emplace_back(f, lo, min(n, lo + step));
+    for (auto& th : pool) th.join();
+  }
+
+  // bkt[c] = start (end = false) or end (end = true) of bucket c.
+  // Symbols are recounted on every call instead of keeping a second alphabet-sized array;
+  // per-thread histograms when the alphabet is small.
+  template<class Index, class Text>
+  static void get_buckets(const Text& text, size_t n, vector<Index>& bkt, bool end, int threads) {
+    const size_t alphabet = bkt.size();
+    fill(bkt.begin(), bkt.end(), 0);
+    if (threads <= 1 || n < PARALLEL_MIN || alphabet * threads > n / 8) {
+      for (size_t i = 0; i < n; ++i) ++bkt[text[i]];
+    } else {
+      vector<vector<Index>> local(threads, vector<Index>(alphabet, 0));
+      atomic<int> slot{0};
+      parallel_for(n, threads, [&](size_t lo, size_t hi) {
+        auto& cnt = local[slot++];
+        for (size_t i = lo; i < hi; ++i) ++cnt[text[i]];
+      });
+      for (auto& cnt : local)
+        for (size_t c = 0; c < alphabet; ++c) bkt[c] += cnt[c];
+    }
+    Index sum = 0;
+    for (size_t c = 0; c < alphabet; ++c) { sum += bkt[c]; bkt[c] = end ? sum : sum - bkt[c]; }
+  }
+
+  // L/S types (true = L); the last symbol is the sentinel, S-type.
+  // Parallel version: every block resolves its types right to left, except the run of equal
+  // symbols touching its right border, whose type depends on the next block; those runs are
+  // filled afterwards right to left. Blocks are multiples of 64 so vector<bool> words are
+  // never shared between threads.
+  template<class Text>
+  static void classify(const Text& text, size_t n, vector<bool>& isLType, int threads) {
+    isLType[n - 1] = false;
+    if (threads <= 1 || n < PARALLEL_MIN) {
+      for (size_t i = n - 1; i-- > 0;)
+        isLType[i] = (text[i] > text[i + 1]) || (text[i] == text[i + 1] && isLType[i + 1]);
+      return;
+    }
+
+    const size_t B = piece_size(n, threads, 64);
+    const size_t blocks = (n + B - 1) / B;
+    vector<size_t> runStart(blocks);      // types of [runStart, hi) wait for the next block
+
+    parallel_for(n, threads, [&](size_t lo, size_t hi) {
+      size_t r = hi - 1;
+      if (hi < n) while (r > lo && text[r - 1] == text[hi - 1]) --r;
+      for (size_t i = r; i-- > lo;)
+        isLType[i] = (text[i] > text[i + 1]) || (text[i] == text[i + 1] && isLType[i + 1]);
+      runStart[lo / B] = (hi < n) ? r : hi;
+    }, 64);
+    for (size_t k = blocks - 1; k-- > 0;) {
+      size_t hi = (k + 1) * B;
+      auto c = text[hi - 1];
+      bool t = (text[hi] != c) ? (c > text[hi]) : isLType[hi];
+      for (size_t i = runStart[k]; i < hi; ++i) isLType[i] = t;
+    }
+  }
+
+  // One induced-sort scan (L: left to right into bucket heads, S: right to left into tails).
+  // Blocked buffering: the symbol text[p-1] and type of p-1 for every filled slot of the
+  // next SCAN_BLOCK entries are looked up in parallel, then the writes happen in order.
+  // Slots filled during the same block are not in the buffer and are looked up inline.
+  template<class Index, class Text>
+  static void induce_scan(const Text& text, size_t n, Index* sa, const vector<bool>& isLType,
+                          vector<Index>& ptr, bool lscan, int threads) {
+    const Index NONE = EMPTY<Index>;
+    auto want = [&](Index p) -> Index {  // symbol of p-1 if p-1 is induced by this scan
+      return (p != NONE && p > 0 && isLType[p - 1] == lscan) ? (Index)text[p - 1] : NONE;
+    };
+    if (threads <= 1 || n < PARALLEL_MIN) {
+      if (lscan) {
+        for (size_t idx = 0; idx < n; ++idx) { Index c = want(sa[idx]); if (c != NONE) sa[ptr[c]++] = sa[idx] - 1; }
+      } else {
+        for (size_t idx = n; idx-- > 0;) { Index c = want(sa[idx]); if (c != NONE) sa[--ptr[c]] = sa[idx] - 1; }
+      }
+      return;
+    }
+
+    vector<Index> snap(SCAN_BLOCK), sym(SCAN_BLOCK);
+    for (size_t done = 0; done < n; done += SCAN_BLOCK) {
+      size_t len = min(SCAN_BLOCK, n - done);
+      size_t b = lscan ? done : n - done - len;
+      parallel_for(len, threads, [&](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) { snap[j] = sa[b + j]; sym[j] = want(snap[j]); }
+      });
+      for (size_t k = 0; k < len; ++k) {
+        size_t j = lscan ? k : len - 1 - k;
+        Index p = sa[b + j];
+        Index c = (p == snap[j]) ? sym[j] : want(p);
+        if (c == NONE) continue;
+        if (lscan) sa[ptr[c]++] = p - 1;
+        else sa[--ptr[c]] = p - 1;
+      }
+    }
+  }
+
+  // Suffix array of text[0..n) into sa[0..n). text[n-1] must be a unique smallest sentinel 0,
+  // all symbols < alphabet. Besides sa, a level only needs n type bits and one
+  // alphabet-sized bucket array: the reduced problem (names, reduced string and its SA)
+  // lives inside sa itself (Nong, Zhang & Chan 2009).
+  template<class Index, class Text>
+  static void sa_is(const Text& text, Index n, Index alphabet, Index* sa, int threads = 1) {
+    const Index NONE = EMPTY<Index>;
+    if (n == 1) { sa[0] = 0; return; }
+
+    vector<bool> isLType(n);
+    classify(text, n, isLType, threads);
+    auto is_lms = [&](Index i) -> bool { return i > 0 && !isLType[i] && isLType[i - 1]; };
+
+    // Stage 1: sort LMS substrings by one induced sort from unsorted LMS seeds
+    vector<Index> bkt(alphabet);
+    get_buckets(text, n, bkt, true, threads);
+    fill(sa, sa + n, NONE);
+    for (Index i = 1; i < n; ++i)
+      if (is_lms(i)) sa[--bkt[text[i]]] = i;
+    get_buckets(text, n, bkt, false, threads);
+    induce_scan(text, n, sa, isLType, bkt, true, threads);
+    get_buckets(text, n, bkt, true, threads);
+    induce_scan(text, n, sa, isLType, bkt, false, threads);
+    vector<Index>().swap(bkt);
+
+    // sorted LMS substrings to sa[0..n1)
+    Index n1 = 0;
+    for (Index i = 0; i < n; ++i)
+      if (is_lms(sa[i])) sa[n1++] = sa[i];
+
+    // Name LMS substrings; LMS positions are >= 2 apart, so pos / 2 indexes sa[n1..n) uniquely.
+    // Neighbour comparisons run in parallel twice: once to count names per piece, once to write.
+    auto equal_lms = [&](Index a, Index b) -> bool {
+      for (Index d = 0;; ++d) {
+        if (text[a + d] != text[b + d] || isLType[a + d] != isLType[b + d]) return false;
+        if (d > 0 && (is_lms(a + d) || is_lms(b + d))) return is_lms(a + d) && is_lms(b + d);
+      }
+    };
+    fill(sa + n1, sa + n, NONE);
+    const size_t P = piece_size(n1, threads, 1);
+    vector<Index> firstName(n1 / P + 2, 0);   // first name used by each piece
+    if (threads > 1 && n1 >= PARALLEL_MIN) {
+      parallel_for(n1, threads, [&](size_t lo, size_t hi) {
+        Index cnt = 0;
+        for (size_t k = max<size_t>(lo, 1); k < hi; ++k) cnt += !equal_lms(sa[k - 1], sa[k]);
+        firstName[lo / P + 1] = cnt;
+      });
+      partial_sum(firstName.begin(), firstName.end(), firstName.begin());
+    }
+    parallel_for(n1, threads, [&](size_t lo, size_t hi) {
+      Index name = firstName[lo / P];
+      for (size_t k = lo; k < hi; ++k) {
+        if (k > 0 && !equal_lms(sa[k - 1], sa[k])) ++name;
+        sa[n1 + sa[k] / 2] = name;
+      }
+    });
+    Index names = sa[n1 + sa[n1 - 1] / 2] + 1;
+
+    // reduced string s1 = names in text order, packed at the end of sa
+    for (Index i = n, j = n; i-- > n1;)
+      if (sa[i] != NONE) sa[--j] = sa[i];
+    Index* s1 = sa + n - n1;
+
+    // Stage 2: SA of s1 into sa[0..n1)
+    if (names < n1) sa_is<Index>((const Index*)s1, n1, names, sa, threads);
+    else for (Index i = 0; i < n1; ++i) sa[s1[i]] = i;
+
+    // Stage 3: seed with the LMS suffixes in sorted order and induce the rest
+    for (Index i = 1, j = 0; i < n; ++i)
+      if (is_lms(i)) s1[j++] = i;        // s1 becomes the LMS positions in text order
+    for (Index i = 0; i < n1; ++i) sa[i] = s1[sa[i]];
+    fill(sa + n1, sa + n, NONE);
+    bkt.assign(alphabet, 0);
+    get_buckets(text, n, bkt, true, threads);
+    for (Index i = n1; i-- > 0;) {
+      Index j = sa[i];
+      sa[i] = NONE;
+      sa[--bkt[text[j]]] = j;
+    }
+    get_buckets(text, n, bkt, false, threads);
+    induce_scan(text, n, sa, isLType, bkt, true, threads);
+    get_buckets(text, n, bkt, true, threads);
+    induce_scan(text, n, sa, isLType, bkt, false, threads);
+  }
+
+} // namespace SAIS
+
+// O(1) range-minimum with O(n) words: blocks of 32, a sparse table over the block minima,
+// and inside a block a 32-bit mask per position of its min-stack (positions whose value is
+// not beaten by anything after them up to here). Returns the position of the leftmost
+// minimum. The array is passed to query so copies never hold a stale pointer.
+template<class Index>
+struct BlockRMQ {
+  static const int B = 32;
+  Table<uint32_t> mask;            // mask[i] bit j: block_start + j is on the min-stack at i
+  vector<Table<Index>> top;        // top[k][b] = argmin over blocks b .. b + 2^k - 1
+
+  static int floor_log2(size_t x) { return 63 - __builtin_clzll(x); }
+
+  void build(const Index* a, size_t m) {
+    vector<uint32_t> mk(m, 0);
+    for (size_t bs = 0; bs < m; bs += B) {
+      uint32_t cur = 0;
+      for (size_t i = bs; i < min(m, bs + B); ++i) {
+        while (cur && a[bs + 31 - __builtin_clz(cur)] > a[i]) cur &= ~(1u << (31 - __builtin_clz(cur)));
+        cur |= 1u << (i - bs);
+        mk[i] = cur;
+      }
+    }
+    mask = move(mk);
+    size_t blocks = (m + B - 1) / B;
+    top.assign(levels(m), Table<Index>());
+    if (!blocks) return;
+    vector<Index> row(blocks);
+    for (size_t b = 0; b < blocks; ++b) row[b] = in_block(b * B, min(m, (b + 1) * B) - 1);
+    top[0] = move(row);
+    for (size_t k = 1; k < top.size(); ++k) {
+      size_t half = (size_t)1 << (k - 1);
+      row.assign(blocks - 2 * half + 1, 0);
+      for (size_t b = 0; b < row.size(); ++b) row[b] = better(a, top[k - 1][b], top[k - 1][b + half]);
+      top[k] = move(row);
+    }
+  }
+
+  // rows of top for an array of m values
+  static size_t levels(size_t m) {
+    size_t blocks = (m + B - 1) / B;
+    return blocks ? floor_log2(blocks) + 1 : 0;
+  }
+
+  static Index better(const Index* a, Index x, Index y) { return a[y] < a[x] ? y : x; }
+
+  // argmin of a[l..r], l and r in the same block
+  Index in_block(size_t l, size_t r) const {
+    return (Index)((r & ~(size_t)(B - 1)) + __builtin_ctz(mask[r] & (~0u << (l % B))));
+  }
+
+  // argmin of a[l..r] inclusive
+  Index query(const Index* a, size_t l, size_t r) const {
+    size_t bl = l / B, br = r / B;
+    if (bl == br) return in_block(l, r);
+    Index best = better(a, in_block(l, bl * B + B - 1), in_block(br * B, r));
+    if (bl + 1 < br) {
+      int k = floor_log2(br - bl - 1);
+      Index mid = better(a, top[k][bl + 1], top[k][br - ((size_t)1 << k)]);
+      best = a[mid] < a[best] || (a[mid] == a[best] && mid < best) ? mid : best;
+    }
+    return best;
+  }
+
+  size_t bytes() const {
+    size_t b = mask.size() * sizeof(uint32_t);
+    for (auto& row : top) b += row.size() * sizeof(Index);
+    return b;
+  }
+};
+
+enum RmqMode { SPARSE_TABLE, BLOCK_SPARSE };
+
+// KASAI: rank-order Kasai, one thread. PHI: Phi/PLCP (Karkkainen, Manzini, Puglisi), which
+// walks the text in order and splits into blocks across threads. PHI_COMPRESSED: PHI, but
+// without an RMQ the LCP is kept only as the 2n-bit PLCP bit vector below.
+enum LcpMode { KASAI, PHI, PHI_COMPRESSED };
+
+// PLCP in 2n + 1 bits: plcp[p] + p never decreases, so p-th one sits at plcp[p] + 2p and
+// the gaps are unary. select1 goes through a sample every 512 ones and a binary search
+// over the ones before each 512-bit superblock.
+template<class Index>
+struct CompressedPLCP {
+  static const size_t SAMPLE = 512;
+  Table<uint64_t> words;
+  Table<uint64_t> super;           // super[b] = ones in words[0 .. 8b)
+  Table<uint64_t> sel;             // sel[k] = superblock holding the (k * SAMPLE)-th one
+
+  static size_t word_count(size_t n) { return (2 * n + 1 + 63) / 64 + 1; }
+  static size_t super_count(size_t n) { return word_count(n) / 8 + 2; }
+  static size_t sel_count(size_t n) { return n / SAMPLE + 2; }
+
+  void build(const Index* plcp, size_t n) {
+    vector<uint64_t> w(word_count(n), 0);
+    for (size_t p = 0; p < n; ++p) {
+      size_t at = (size_t)plcp[p] + 2 * p;
+      w[at >> 6] |= 1ULL << (at & 63);
+    }
+    vector<uint64_t> sup(super_count(n), 0), sl(sel_count(n), (w.size() - 1) / 8);
+    uint64_t acc = 0;
+    for (size_t k = 0; k < w.size(); ++k) {
+      if (k % 8 == 0) sup[k / 8] = acc;
+      uint64_t c = __builtin_popcountll(w[k]);
+      for (uint64_t j = (acc + SAMPLE - 1) / SAMPLE; j * SAMPLE < acc + c; ++j) sl[j] = k / 8;
+      acc += c;
+    }
+    sup[w.size() / 8 + 1] = acc;
+    words = move(w); super = move(sup); sel = move(sl);
+  }
+
+  // bit position of the i-th one (0-based)
+  size_t select1(size_t i) const {
+    size_t lo = sel[i / SAMPLE], hi = sel[i / SAMPLE + 1];
+    while (lo < hi) {                  // last superblock with fewer than i + 1 ones before it
+      size_t mid = (lo + hi + 1) / 2;
+      if (super[mid] <= i) lo = mid; else hi = mid - 1;
+    }
+    size_t r = i - super[lo], k = lo * 8;
+    for (size_t c; (c = __builtin_popcountll(words[k])) <= r; ++k) r -= c;
+    uint64_t x = words[k];
+    for (; r; --r) x &= x - 1;
+    return k * 64 + __builtin_ctzll(x);
+  }
+
+  Index operator()(size_t p) const { return (Index)(select1(p) - 2 * p); }
+
+  size_t bytes() const { return (words.size() + super.size() + sel.size()) * sizeof(uint64_t); }
+};
+
+// Index = uint32_t handles strings shorter than 4 GiB - 1, uint64_t anything larger.
+// Construction peak is the string, sa (n + 1 indexes) and n / 8 type bytes, plus one
+// bucket array per recursion level: about 5n-7n bytes with 32-bit indexes.
+template<class Index>
+struct BasicSuffixArray {
+  Index n = 0;                     // string length
+  Table<char> s;                   // original string
+  Table<Index> sa;                 // sa[i] = start index of i-th suffix
+  Table<Index> rankAt;             // rankAt[pos] = rank of suffix at pos
+  Table<Index> lcp;                // lcp[i] = LCP(sa[i], sa[i+1]), empty when only plcp is kept
+  CompressedPLCP<Index> plcp;      // PHI_COMPRESSED without RMQ: lcp[i] = plcp(sa[i + 1])
+  vector<Table<Index>> st;         // sparse table over lcp
+  BlockRMQ<Index> brmq;            // linear-space alternative to st
+  bool WANT_RMQ = true;            // toggle RMQ build
+  RmqMode RMQ_MODE = SPARSE_TABLE; // which RMQ build() makes: n log n sparse table or O(n) block RMQ
+  LcpMode LCP_MODE = KASAI;        // which LCP builder build() runs and how the LCP is kept
+  shared_ptr<void> image;          // keeps a loaded file mapped while any copy uses it
+
+  BasicSuffixArray() {}
+  explicit BasicSuffixArray(const string& str, bool build_rmq = true, int threads = 1) { build(str, build_rmq, threads); }
+
+  static int floor_log2(size_t x) { return 63 - __builtin_clzll(x); }
+
+  // threads > 1 runs SA-IS (and the PHI LCP builders) on that many threads, threads <= 0
+  // uses every hardware thread; the result is the same for any thread count. Throws
+  // length_error if the input does not fit in Index (use SuffixArray64 above 4 GiB)
+  void build(const string& str, bool build_rmq = true, int threads = 1) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    if (str.size() + 1 >= (size_t)SAIS::EMPTY<Index>)
+      throw length_error("SuffixArray: input too long for Index");
+    image.reset();
+    s = vector<char>(str.begin(), str.end()); n = (Index)s.size();
+
+    const Index ALPHABET = 257;    // 256 bytes + sentinel
+    vector<Index> suf((size_t)n + 1, 0); // SA with sentinel suffix at suf[0]
+    SAIS::sa_is<Index>(SAIS::ByteText{(const unsigned char*)s.data(), s.size()}, n + 1, ALPHABET, suf.data(), threads);
+    suf.erase(suf.begin());
+    sa = move(suf);
+
+    vector<Index> rk(n, 0);        // inverse SA
+    for (Index i = 0; i < n; ++i) rk[sa[i]] = i;
+    rankAt = move(rk);
+
+    WANT_RMQ = build_rmq;
+    plcp = CompressedPLCP<Index>();
+    if (LCP_MODE == KASAI) lcp = kasai();
+    else {
+      vector<Index> pl = phi_plcp(threads);
+      if (LCP_MODE == PHI_COMPRESSED && !WANT_RMQ) {
+        plcp.build(pl.data(), n);
+        lcp = vector<Index>();
+      } else {
+        vector<Index> lc(n > 0 ? n - 1 : 0); // lcp[i] = plcp[sa[i + 1]]
+        SAIS::parallel_for(lc.size(), threads, [&](size_t lo, size_t hi) {
+          for (size_t i = lo; i < hi; ++i) lc[i] = pl[sa[i + 1]];
+        });
+        lcp = move(lc);
+      }
+    }
+
+    init_rmq();
+  }
+
+  // (Re)build the RMQ that WANT_RMQ and RMQ_MODE ask for over lcp. If only the compressed
+  // PLCP is kept (PHI_COMPRESSED built without RMQ), lcp is expanded from it first.
+  void init_rmq() {
+    st.clear();
+    brmq = BlockRMQ<Index>();
+    if (WANT_RMQ && n >= 2 && lcp.empty()) {
+      vector<Index> lc(n - 1);
+      for (Index i = 0; i + 1 < n; ++i) lc[i] = plcp(sa[i + 1]);
+      lcp = move(lc);
+      plcp = CompressedPLCP<Index>();
+    }
+    if (WANT_RMQ && n >= 2 && RMQ_MODE == BLOCK_SPARSE) brmq.build(lcp.data(), lcp.size());
+    if (WANT_RMQ && n >= 2 && RMQ_MODE == SPARSE_TABLE) {
+      size_t m = n - 1;             // lcp size
+      int K = floor_log2(m) + 1;
+      st.assign(K, Table<Index>());
+      st[0] = lcp;
+      for (int k = 1; k < K; ++k) {
+        size_t len = (size_t)1 << k, half = len >> 1;
+        vector<Index> row(m - len + 1);
+        for (size_t i = 0; i + len - 1 < m; ++i)
+          row[i] = min(st[k - 1][i], st[k - 1][i + half]);
+        st[k] = move(row);
+      }
+    }
+  }
+
+  // Kasai: suffixes in text order, lcp[rankAt[i]] >= lcp[rankAt[i - 1]] - 1
+  vector<Index> kasai() const {
+    vector<Index> lc(n > 0 ? n - 1 : 0, 0);
+    for (Index i = 0, h = 0; i < n; ++i) {
+      Index r = rankAt[i];
+      if (r == n - 1) { h = 0; continue; }
+      Index j = sa[r + 1];
+      while (i + h < n && j + h < n && s[i + h] == s[j + h]) ++h;
+      lc[r] = h;
+      if (h) --h;
+    }
+    return lc;
+  }
+
+  // PLCP in text order: plcp[p] = LCP(p, phi[p]) with phi[p] the suffix ranked just below
+  // p, 0 for the smallest. Both arrays share one buffer and are read and written
+  // sequentially; each thread restarts h at 0 at the start of its block.
+  vector<Index> phi_plcp(int threads) const {
+    vector<Index> pl(n);
+    const Index NONE = SAIS::EMPTY<Index>;
+    SAIS::parallel_for(n, threads, [&](size_t lo, size_t hi) {
+      for (size_t i = lo; i < hi; ++i) pl[sa[i]] = i ? sa[i - 1] : NONE;
+    });
+    SAIS::parallel_for(n, threads, [&](size_t lo, size_t hi) {
+      Index h = 0;
+      for (size_t i = lo; i < hi; ++i) {
+        Index j = pl[i];
+        if (j == NONE) { pl[i] = h = 0; continue; }
+        while (i + h < n && j + h < n && s[i + h] == s[j + h]) ++h;
+        pl[i] = h;
+        if (h) --h;
+      }
+    });
+    return pl;
+  }
+
+  // LCP(sa[i], sa[i + 1]) whichever way it is stored
+  Index lcp_at(Index i) const { return lcp.empty() ? plcp(sa[i + 1]) : lcp[i]; }
+
+  // Image file (see MappedImage.h): header, then s, sa, rankAt, lcp, the compressed PLCP
+  // (PHI_COMPRESSED without RMQ, lcp is then empty) and the RMQ rows, in native Index width.
+  // The checksum is FNV-1a over the 64-bit words after the header. load() maps the file and
+  // every query reads the mapped pages directly.
+  struct ImageHeader {
+    char magic[8];
+    uint32_t version, index_bytes;
+    uint32_t want_rmq, rmq_mode, lcp_compressed, pad;
+    uint64_t n, file_size, checksum;
+  };
+  static constexpr char IMAGE_MAGIC[8] = {'S', 'A', 'I', 'M', 'A', 'G', 'E', 0};
+  static const uint32_t IMAGE_VERSION = 2;
+
+  // {offset, bytes} of every section for the given header
+  static Image::Layout image_sections(const ImageHeader& h) {
+    size_t n = h.n, m = n > 0 ? n - 1 : 0;
+    vector<size_t> sizes = {n, n * sizeof(Index), n * sizeof(Index), h.lcp_compressed ? 0 : m * sizeof(Index)};
+    if (h.lcp_compressed) {
+      sizes.push_back(CompressedPLCP<Index>::word_count(n) * sizeof(uint64_t));
+      sizes.push_back(CompressedPLCP<Index>::super_count(n) * sizeof(uint64_t));
+      sizes.push_back(CompressedPLCP<Index>::sel_count(n) * sizeof(uint64_t));
+    }
+    if (h.want_rmq && n >= 2 && h.rmq_mode == SPARSE_TABLE)
+      for (int k = 0; k <= floor_log2(m); ++k) sizes.push_back((m - ((size_t)1 << k) + 1) * sizeof(Index));
+    if (h.want_rmq && n >= 2 && h.rmq_mode == BLOCK_SPARSE) {
+      size_t blocks = (m + BlockRMQ<Index>::B - 1) / BlockRMQ<Index>::B;
+      sizes.push_back(m * sizeof(uint32_t));
+      for (size_t k = 0; k < BlockRMQ<Index>::levels(m); ++k)
+        sizes.push_back((blocks - ((size_t)1 << k) + 1) * sizeof(Index));
+    }
+    return Image::layout(sizeof(ImageHeader), sizes);
+  }
+
+  // Write the built index to path; false on I/O error
+  bool save(const string& path) const {
+    ImageHeader h{};
+    memcpy(h.magic, IMAGE_MAGIC, 8);
+    h.version = IMAGE_VERSION;
+    h.index_bytes = sizeof(Index);
+    h.want_rmq = WANT_RMQ; h.rmq_mode = RMQ_MODE;
+    h.lcp_compressed = !plcp.words.empty();
+    h.n = n;
+    auto sec = image_sections(h);
+    h.file_size = Image::file_size(sec);
+
+    vector<const void*> data = {s.data(), sa.data(), rankAt.data(), lcp.data()};
+    if (h.lcp_compressed) data.insert(data.end(), {plcp.words.data(), plcp.super.data(), plcp.sel.data()});
+    for (auto& row : st) data.push_back(row.data());
+    if (!brmq.top.empty()) {
+      data.push_back(brmq.mask.data());
+      for (auto& row : brmq.top) data.push_back(row.data());
+    }
+    return Image::write(path, h, sec, data, &ImageHeader::checksum);
+  }
+
+  // Map an image written by save(). false if the file is missing, truncated, from another
+  // format version or Index width, or (with verify) fails the checksum. verify reads the
+  // whole file; without it only the pages that queries touch are ever read.
+  bool load(const string& path, bool verify = false) {
+    size_t size = 0;
+    shared_ptr<void> map = Image::map_file(path, Image::pad8(sizeof(ImageHeader)), size);
+    if (!map) return false;
+
+    ImageHeader h;
+    memcpy(&h, map.get(), sizeof(h));
+    if (memcmp(h.magic, IMAGE_MAGIC, 8) != 0 || h.version != IMAGE_VERSION ||
+        h.index_bytes != sizeof(Index) || h.file_size != size || h.n > size ||
+        h.n + 1 >= (uint64_t)SAIS::EMPTY<Index>)
+      return false;
+    auto sec = image_sections(h);
+    if (!Image::fits(sec, size)) return false;
+    const char* base = (const char*)map.get();
+    if (verify) {
+      size_t off = Image::pad8(sizeof(ImageHeader));
+      if (Image::fnv1a((const uint64_t*)(base + off), (size - off) / 8) != h.checksum) return false;
+    }
+    auto at = [&](size_t i) { return (const Index*)(base + sec[i].first); };
+
+    n = (Index)h.n;
+    WANT_RMQ = h.want_rmq; RMQ_MODE = (RmqMode)h.rmq_mode;
+    s.view(base + sec[0].first, n);
+    sa.view(at(1), n);
+    rankAt.view(at(2), n);
+    size_t m = n > 0 ? n - 1 : 0, next = 4;
+    lcp.view(at(3), h.lcp_compressed ? 0 : m);
+    plcp = CompressedPLCP<Index>();
+    if (h.lcp_compressed) {
+      auto words = [&](size_t i) { return (const uint64_t*)(base + sec[i].first); };
+      plcp.words.view(words(4), sec[4].second / 8);
+      plcp.super.view(words(5), sec[5].second / 8);
+      plcp.sel.view(words(6), sec[6].second / 8);
+      next = 7;
+    }
+    st.clear();
+    brmq = BlockRMQ<Index>();
+    if (WANT_RMQ && n >= 2 && RMQ_MODE == SPARSE_TABLE) {
+      st.resize(sec.size() - next);
+      for (size_t k = 0; k < st.size(); ++k) st[k].view(at(next + k), m - ((size_t)1 << k) + 1);
+    }
+    if (WANT_RMQ && n >= 2 && RMQ_MODE == BLOCK_SPARSE) {
+      size_t blocks = (m + BlockRMQ<Index>::B - 1) / BlockRMQ<Index>::B;
+      brmq.mask.view((const uint32_t*)(base + sec[next].first), m);
+      brmq.top.resize(sec.size() - next - 1);
+      for (size_t k = 0; k < brmq.top.size(); ++k) brmq.top[k].view(at(next + 1 + k), blocks - ((size_t)1 << k) + 1);
+    }
+    image = move(map);
+    return true;
+  }
+
+  // Range minimum on lcp[L..R] inclusive
+  Index rmq_lcp(Index L, Index R) const {
+    if (L > R) return numeric_limits<Index>::max();
+    if (RMQ_MODE == BLOCK_SPARSE) return lcp[brmq.query(lcp.data(), L, R)];
+    int k = floor_log2(R - L + 1);
+    return min(st[k][L], st[k][R - ((Index)1 << k) + 1]);
+  }
+
+  // LCP of suffixes starting at i and j
+  // returns length of the longest common prefix of s[i..] and s[j..]
+  Index get_lcp(Index i, Index j) const {
+    if (i == j) return n - i;
+    Index ri = rankAt[i], rj = rankAt[j];
+    if (ri > rj) swap(ri, rj);
+    if (WANT_RMQ) return rmq_lcp(ri, rj - 1);
+    if (rj == ri + 1) return lcp_at(ri);
+    Index len = 0; // fallback without RMQ
+    while (i + len < n && j + len < n && s[i + len] == s[j + len]) ++len;
+    return len;
+  }
+
+  // Compare suffix s[sa[idx]..] with pattern 'pat' (bytes compared unsigned, as in sa)
+  // returns: -1 if suffix < pat, 0 if equal, +1 if suffix > pat
+  int compare_suffix_with_pattern(Index idx, const string& pat) const {
+    Index i = sa[idx];
+    size_t a = n - i, b = pat.size();
+    size_t len = min(a, b);
+    for (size_t k = 0; k < len; ++k) {
+      if ((unsigned char)s[i + k] < (unsigned char)pat[k]) return -1;
+      if ((unsigned char)s[i + k] > (unsigned char)pat[k]) return +1;
+    }
+    if (a == b) return 0;
+    return (a < b) ? -1 : +1;
+  }
+
+  // What a search looks for: first suffix >= pat, first suffix > pat,
+  // or first suffix that is > pat and does not start with it
+  enum SearchKind { SEARCH_GE, SEARCH_GT, SEARCH_PREFIX_GT };
+
+  // First rank in [lo, hi) whose suffix matches `kind` for pat[0..len), hi if none;
+  // every suffix in [lo, hi) must share its first `skip` characters with pat.
+  // Manber-Myers: l and r are the LCPs of pat with the current borders. With an RMQ the
+  // LCP between the middle suffix and the border with the larger of the two decides most
+  // steps without touching the text, and comparisons resume at max(l, r), which never
+  // decreases: O(m + log n). Without an RMQ comparisons resume at min(l, r).
+  Index search(const string& pat, SearchKind kind, Index lo, Index hi, size_t skip = 0,
+               size_t len = string::npos) const {
+    const size_t m = min(len, pat.size());
+    const bool fast = WANT_RMQ && n >= 2;
+    int64_t L = (int64_t)lo - 1, R = hi; // borders start virtual, outside [lo, hi)
+    size_t l = skip, r = skip;
+    while (R - L > 1) {
+      int64_t M = (L + R) >> 1;
+      size_t k = min(l, r);              // characters of suffix M known to match pat
+      if (fast && l >= r) {
+        if (L >= (int64_t)lo) {
+          size_t lm = rmq_lcp(L, M - 1);
+          if (lm > l) { L = M; continue; }
+          if (lm < l) { R = M; r = lm; continue; }
+        }
+        k = l;
+      } else if (fast) {
+        if (R < (int64_t)hi) {
+          size_t mr = rmq_lcp(M, R - 1);
+          if (mr > r) { R = M; continue; }
+          if (mr < r) { L = M; l = mr; continue; }
+        }
+        k = r;
+      }
+      Index i = sa[M];
+      while (k < m && i + k < n && s[i + k] == pat[k]) ++k;
+      bool right;
+      if (k == m) right = kind == SEARCH_GE || (kind == SEARCH_GT && n - i > m);
+      else if (i + k == n) right = false;
+      else right = (unsigned char)s[i + k] > (unsigned char)pat[k];
+      if (right) { R = M; r = k; }
+      else { L = M; l = k; }
+    }
+    return (Index)R;
+  }
+
+  // First suffix >= pattern
+  Index lower_bound_pattern(const string& pat) const { return search(pat, SEARCH_GE, 0, n); }
+
+  // First suffix > pattern
+  Index upper_bound_pattern(const string& pat) const { return search(pat, SEARCH_GT, 0, n); }
+
+  // Half-open range [L, R) of suffixes that start with 'pat'
+  pair<Index,Index> find_occurrences(const string& pat) const {
+    Index L = search(pat, SEARCH_GE, 0, n);
+    Index R = search(pat, SEARCH_PREFIX_GT, L, n, 0);
+    return {L, R};
+  }
+
+  // find_occurrences for every pattern, res[i] belongs to pats[i].
+  // Patterns are sorted so that shared prefixes are adjacent; a stack keeps the SA interval
+  // of the prefixes of the previous pattern, and each pattern starts narrowing from the
+  // interval of the prefix it shares with its predecessor instead of from the whole SA.
+  // The sorted batch is cut into one contiguous piece per thread.
+  vector<pair<Index,Index>> find_occurrences_batch(const vector<string>& pats, int threads = 1) const {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    vector<size_t> order(pats.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pats[a] < pats[b]; });
+
+    vector<pair<Index,Index>> res(pats.size());
+    SAIS::parallel_for(order.size(), threads, [&](size_t from, size_t to) {
+      struct Frame { size_t depth; Index lo, hi; };
+      vector<Frame> stk = {{0, 0, n}};   // interval of pat[0..depth) for growing depth
+      const string* prev = nullptr;
+      for (size_t k = from; k < to; ++k) {
+        const string& pat = pats[order[k]];
+        size_t c = 0;                     // common prefix with the previous pattern
+        if (prev) while (c < pat.size() && c < prev->size() && pat[c] == (*prev)[c]) ++c;
+        while (stk.back().depth > c) stk.pop_back();
+        for (size_t d : {c, pat.size()}) {
+          Frame top = stk.back();
+          if (top.depth == d) continue;
+          Index L = search(pat, SEARCH_GE, top.lo, top.hi, top.depth, d);
+          Index R = search(pat, SEARCH_PREFIX_GT, L, top.hi, top.depth, d);
+          stk.push_back({d, L, R});
+        }
+        res[order[k]] = {stk.back().lo, stk.back().hi};
+        prev = &pat;
+      }
+    });
+    return res;
+  }
+
+  // An lcp-interval [lb, rb] of ranks: an internal node of the suffix tree whose string
+  // s[sa[lb] .. + lcp) occurs rb - lb + 1 times
+  struct LcpInterval {
+    Index lcp, lb, rb;
+    Index parent_lcp;              // lcp of the enclosing interval
+    bool has_child;                // some child is an interval, not just a single suffix
+  };
+
+  // f(interval) for every lcp-interval with lcp > 0, children before their parent and in
+  // increasing rb. Bottom-up traversal (Abouelhoda, Kurtz, Ohlebusch): the stack holds the
+  // open intervals on the path to the current suffix, O(n) time.
+  template<class F>
+  void for_each_lcp_interval(F&& f) const {
+    struct Frame { Index lcp, lb; bool child; };
+    vector<Frame> stk = {{0, 0, false}};
+    for (Index i = 1; i <= n; ++i) {
+      Index h = i < n ? lcp_at(i - 1) : 0, lb = i - 1;
+      bool child = false;            // the interval pushed for h encloses a popped one
+      while (h < stk.back().lcp) {
+        Frame top = stk.back();
+        stk.pop_back();
+        f(LcpInterval{top.lcp, top.lb, i - 1, max(h, stk.back().lcp), top.child});
+        lb = top.lb;
+        if (stk.back().lcp >= h) stk.back().child = true; else child = true;
+      }
+      if (h > stk.back().lcp) stk.push_back({h, lb, child});
+    }
+  }
+
+  struct Repeat { Index pos, len, count; }; // s[pos .. pos + len) occurs count times
+  struct Repeats {
+    vector<Repeat> maximal;        // left- and right-maximal, len >= min_len
+    vector<Repeat> supermaximal;   // maximal and not inside another maximal repeat
+    vector<Repeat> frequent;       // most frequent substrings of length >= k, by count
+  };
+
+  // All three repeat classes from one traversal. An interval is right-maximal by
+  // construction; it is left-maximal when the characters before its suffixes differ, i.e.
+  // the BWT changes somewhere inside it (position 0 counts as a unique character).
+  // Supermaximal: no child interval and pairwise distinct characters before its suffixes.
+  // frequent: intervals with lcp >= k whose parent has lcp < k, one per distinct length-k
+  // substring occurring twice or more; every prefix of length k .. len of the reported
+  // string has the same count. The `top` largest counts are kept.
+  Repeats mine_repeats(Index min_len = 1, Index k = 1, size_t top = 10) const {
+    auto before = [&](Index r) { return sa[r] ? (int)(unsigned char)s[sa[r] - 1] : 256; };
+    Repeats res;
+    Index scanned = 0, last_break = 0;   // last rank r <= scanned with before(r) != before(r - 1)
+    vector<Index> stamp(257, 0);
+    Index stamp_id = 0;
+    for_each_lcp_interval([&](const LcpInterval& v) {
+      while (scanned < v.rb) {
+        ++scanned;
+        if (before(scanned) != before(scanned - 1)) last_break = scanned;
+      }
+      Repeat rep{sa[v.lb], v.lcp, v.rb - v.lb + 1};
+      if (v.lcp >= min_len && last_break > v.lb) {
+        res.maximal.push_back(rep);
+        bool distinct = !v.has_child;
+        ++stamp_id;
+        for (Index r = v.lb; distinct && r <= v.rb; ++r) {
+          int c = before(r);
+          distinct = stamp[c] != stamp_id;
+          stamp[c] = stamp_id;
+        }
+        if (distinct) res.supermaximal.push_back(rep);
+      }
+      if (v.lcp >= k && v.parent_lcp < k) res.frequent.push_back(rep);
+    });
+    auto by_count = [](const Repeat& a, const Repeat& b) { return a.count > b.count || (a.count == b.count && a.pos < b.pos); };
+    if (res.frequent.size() > top) {
+      nth_element(res.frequent.begin(), res.frequent.begin() + top, res.frequent.end(), by_count);
+      res.frequent.resize(top);
+    }
+    sort(res.frequent.begin(), res.frequent.end(), by_count);
+    return res;
+  }
+};
+
+using SuffixArray = BasicSuffixArray<uint32_t>;
+using SuffixArray64 = BasicSuffixArray<uint64_t>;
+
+// Bit vector with rank: one 64-bit count before every 512-bit superblock (12.5% extra)
+struct RankBitVector {
+  vector<uint64_t> words;
+  vector<uint64_t> super;          // super[b] = ones in words[0 .. 8b)
+  size_t len = 0;
+
+  void init(size_t n) { len = n; words.assign((n + 63) / 64 + 1, 0); }
+  void set(size_t i) { words[i >> 6] |= 1ULL << (i & 63); }
+  bool get(size_t i) const { return words[i >> 6] >> (i & 63) & 1; }
+
+  void build_rank() {
+    super.assign(words.size() / 8 + 2, 0);
+    uint64_t acc = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+      if (w % 8 == 0) super[w / 8] = acc;
+      acc += __builtin_popcountll(words[w]);
+    }
+    super[words.size() / 8 + 1] = acc;
+  }
+
+  // ones in [0, i)
+  size_t rank1(size_t i) const {
+    size_t w = i >> 6, r = super[w / 8];
+    for (size_t k = w & ~(size_t)7; k < w; ++k) r += __builtin_popcountll(words[k]);
+    if (i & 63) r += __builtin_popcountll(words[w] & ((1ULL << (i & 63)) - 1));
+    return r;
+  }
+  size_t rank0(size_t i) const { return i - rank1(i); }
+
+  size_t bytes() const { return (words.size() + super.size()) * sizeof(uint64_t); }
+};
+
+// Wavelet matrix over symbols [0, sigma): access and rank in O(log sigma), n log sigma bits
+struct WaveletMatrix {
+  int levels = 0;
+  vector<RankBitVector> bv;        // bv[l]: bit (levels - 1 - l) of every symbol, in level-l order
+  vector<size_t> zeros;            // zeros at level l, ones are placed after them
+
+  template<class Sym>
+  void build(vector<Sym> seq, size_t sigma) {
+    levels = 1;
+    while (((size_t)1 << levels) < sigma) ++levels;
+    bv.assign(levels, RankBitVector());
+    zeros.assign(levels, 0);
+    vector<Sym> nxt(seq.size());
+    for (int l = 0; l < levels; ++l) {
+      int bit = levels - 1 - l;
+      bv[l].init(seq.size());
+      size_t z = 0;
+      for (size_t i = 0; i < seq.size(); ++i)
+        if (seq[i] >> bit & 1) bv[l].set(i); else ++z;
+      bv[l].build_rank();
+      zeros[l] = z;
+      size_t zi = 0, oi = z;         // stable partition: zeros first
+      for (size_t i = 0; i < seq.size(); ++i)
+        nxt[(seq[i] >> bit & 1) ? oi++ : zi++] = seq[i];
+      swap(seq, nxt);
+    }
+  }
+
+  size_t access(size_t i) const {
+    size_t c = 0;
+    for (int l = 0; l < levels; ++l) {
+      bool b = bv[l].get(i);
+      c = c << 1 | b;
+      i = b ? zeros[l] + bv[l].rank1(i) : bv[l].rank0(i);
+    }
+    return c;
+  }
+
+  // occurrences of c in [0, i)
+  size_t rank(size_t c, size_t i) const {
+    size_t start = 0;
+    for (int l = 0; l < levels; ++l) {
+      if (c >> (levels - 1 - l) & 1) {
+        i = zeros[l] + bv[l].rank1(i);
+        start = zeros[l] + bv[l].rank1(start);
+      } else {
+        i = bv[l].rank0(i);
+        start = bv[l].rank0(start);
+      }
+    }
+    return i - start;
+  }
+
+  size_t bytes() const {
+    size_t b = 0;
+    for (auto& v : bv) b += v.bytes();
+    return b;
+  }
+};
+
+// FM-index: the BWT of text + sentinel in a wavelet matrix plus every sample_rate-th text
+// position of the SA. Neither the text nor the SA is kept: about n log sigma bits for the
+// BWT and (n / sample_rate) indexes for locate. count is O(m log sigma); locate walks LF at
+// most sample_rate - 1 steps per occurrence.
+template<class Index>
+struct BasicFMIndex {
+  Index N = 0;                     // text length + 1 (sentinel)
+  array<int, 256> code{};          // byte -> symbol, 0 = byte absent (sentinel is symbol 0)
+  size_t sigma = 1;
+  vector<Index> C;                 // C[c] = number of symbols < c in text + sentinel
+  WaveletMatrix bwt;
+  RankBitVector sampled;           // row i has sa[i] % sample_rate == 0
+  vector<Index> samples;           // sa of the sampled rows, in row order
+  Index sample_rate = 32;
+
+  BasicFMIndex() {}
+  explicit BasicFMIndex(const string& str, Index rate = 32, int threads = 1) { build(str, rate, threads); }
+
+  // Throws length_error if the input does not fit in Index
+  void build(const string& str, Index rate = 32, int threads = 1) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    if (str.size() + 1 >= (size_t)SAIS::EMPTY<Index>)
+      throw length_error("FMIndex: input too long for Index");
+    sample_rate = max<Index>(1, rate);
+    N = (Index)str.size() + 1;
+
+    code.fill(0);
+    for (unsigned char b : str) code[b] = 1;
+    sigma = 1;
+    for (int b = 0; b < 256; ++b) if (code[b]) code[b] = sigma++;
+
+    vector<Index> sa(N);
+    SAIS::sa_is<Index>(SAIS::ByteText{(const unsigned char*)str.data(), str.size()}, N, 257, sa.data(), threads);
+
+    vector<uint16_t> last(N);      // BWT as symbols
+    sampled.init(N);
+    samples.clear();
+    for (Index i = 0; i < N; ++i) {
+      last[i] = sa[i] == 0 ? 0 : code[(unsigned char)str[sa[i] - 1]];
+      if (sa[i] % sample_rate == 0) { sampled.set(i); samples.push_back(sa[i]); }
+    }
+    sampled.build_rank();
+    vector<Index>().swap(sa);
+
+    C.assign(sigma + 1, 0);
+    for (auto c : last) ++C[c + 1];
+    partial_sum(C.begin(), C.end(), C.begin());
+    bwt.build(move(last), sigma);
+  }
+
+  // row range [sp, ep) of suffixes starting with pat (backward search)
+  pair<Index,Index> range(const string& pat) const {
+    size_t sp = 0, ep = N;
+    for (size_t k = pat.size(); k-- > 0 && sp < ep;) {
+      int c = code[(unsigned char)pat[k]];
+      if (c == 0) return {0, 0};
+      sp = C[c] + bwt.rank(c, sp);
+      ep = C[c] + bwt.rank(c, ep);
+    }
+    return sp < ep ? make_pair((Index)sp, (Index)ep) : make_pair((Index)0, (Index)0);
+  }
+
+  Index count(const string& pat) const {
+    auto [sp, ep] = range(pat);
+    return ep - sp;
+  }
+
+  // text position of row i: LF steps back to a sampled row
+  Index locate_row(Index i) const {
+    Index steps = 0;
+    while (!sampled.get(i)) {
+      size_t c = bwt.access(i);
+      i = C[c] + bwt.rank(c, i);
+      ++steps;
+    }
+    return samples[sampled.rank1(i)] + steps;
+  }
+
+  // start positions of every occurrence of pat, unordered
+  vector<Index> locate(const string& pat) const {
+    auto [sp, ep] = range(pat);
+    vector<Index> res;
+    res.reserve(ep - sp);
+    for (Index i = sp; i < ep; ++i) res.push_back(locate_row(i));
+    return res;
+  }
+
+  size_t bytes() const {
+    return bwt.bytes() + sampled.bytes() + samples.size() * sizeof(Index) + C.size() * sizeof(Index);
+  }
+};
+
+using FMIndex = BasicFMIndex<uint32_t>;
+
+// Suffix array over a collection of documents. The text is doc 0, separator, doc 1,
+// separator, ...; separators are symbol 1, bytes 2..257, so no match runs across a
+// document boundary. doc[i] is the document of suffix sa[i]. list_documents reports each
+// document containing a pattern once, in time proportional to the number of documents
+// (Muthukrishnan): prev[i] is 1 + the last rank before i in the same document, 0 if none,
+// and the ranks in [L, R) with prev <= L are exactly the first one of every document.
+template<class Index>
+struct BasicGeneralizedSuffixArray {
+  Index n = 0;                     // text length, separators included
+  string s;                        // concatenated documents, separators stored as 0
+  RankBitVector sep;               // separator positions; rank1(p) = document of p
+  vector<Index> starts;            // starts[d] = first position of document d, starts[D] = n
+  vector<Index> sa;                // sa[i] = start index of i-th suffix
+  vector<uint32_t> doc;            // doc[i] = document of sa[i]
+  vector<Index> prev;              // 1 + previous rank with the same document, 0 if none
+  BlockRMQ<Index> prmq;            // argmin over prev
+
+  // SA-IS input: separator 1, byte b as b + 2, virtual sentinel 0 at n
+  struct DocText {
+    const unsigned char* s;
+    const RankBitVector* sep;
+    size_t n;
+    size_t operator[](size_t i) const { return i < n ? (sep->get(i) ? 1 : (size_t)s[i] + 2) : 0; }
+  };
+
+  BasicGeneralizedSuffixArray() {}
+  explicit BasicGeneralizedSuffixArray(const vector<string>& docs, int threads = 1) { build(docs, threads); }
+
+  size_t documents() const { return starts.empty() ? 0 : starts.size() - 1; }
+
+  // Throws length_error if the collection, with one separator per document, does not fit
+  // in Index or has 2^32 - 1 documents or more
+  void build(const vector<string>& docs, int threads = 1) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    if (docs.size() >= numeric_limits<uint32_t>::max())
+      throw length_error("GeneralizedSuffixArray: too many documents");
+    size_t total = docs.size();
+    for (auto& d : docs) total += d.size();
+    if (total + 1 >= (size_t)SAIS::EMPTY<Index>)
+      throw length_error("GeneralizedSuffixArray: collection too long for Index");
+    n = (Index)total;
+
+    s.clear(); s.reserve(n);
+    starts.clear();
+    sep.init(n);
+    for (auto& d : docs) {
+      starts.push_back((Index)s.size());
+      s += d;
+      sep.set(s.size());
+      s.push_back(0);
+    }
+    starts.push_back(n);
+    sep.build_rank();
+
+    const Index ALPHABET = 258;    // sentinel, separator, 256 bytes
+    sa.assign((size_t)n + 1, 0);
+    SAIS::sa_is<Index>(DocText{(const unsigned char*)s.data(), &sep, s.size()}, n + 1, ALPHABET, sa.data(), threads);
+    sa.erase(sa.begin());
+
+    doc.resize(n);
+    prev.resize(n);
+    vector<Index> last(docs.size(), 0);
+    for (Index i = 0; i < n; ++i) {
+      doc[i] = (uint32_t)sep.rank1(sa[i]);
+      prev[i] = last[doc[i]];
+      last[doc[i]] = i + 1;
+    }
+    prmq = BlockRMQ<Index>();
+    if (n) prmq.build(prev.data(), n);
+  }
+
+  // document of text position p and offset inside it
+  pair<uint32_t,Index> position(Index p) const {
+    uint32_t d = (uint32_t)sep.rank1(p);
+    return {d, p - starts[d]};
+  }
+
+  // First rank whose suffix is >= pat (upper = false) or > pat and not prefixed by it;
+  // a suffix ends at its separator. Comparisons resume at min(l, r) of the borders.
+  Index search(const string& pat, bool upper) const {
+    const size_t m = pat.size();
+    int64_t L = -1, R = n;
+    size_t l = 0, r = 0;
+    while (R - L > 1) {
+      int64_t M = (L + R) >> 1;
+      Index i = sa[M];
+      size_t k = min(l, r);
+      while (k < m && !sep.get(i + k) && s[i + k] == pat[k]) ++k;
+      bool right;
+      if (k == m) right = !upper;
+      else if (sep.get(i + k)) right = false;
+      else right = (unsigned char)s[i + k] > (unsigned char)pat[k];
+      if (right) { R = M; r = k; }
+      else { L = M; l = k; }
+    }
+    return (Index)R;
+  }
+
+  // Half-open range [L, R) of suffixes that start with 'pat'
+  pair<Index,Index> find_occurrences(const string& pat) const {
+    return {search(pat, false), search(pat, true)};
+  }
+
+  // Every document containing pat, each once, unordered
+  vector<uint32_t> list_documents(const string& pat) const {
+    auto [L, R] = find_occurrences(pat);
+    vector<uint32_t> res;
+    vector<pair<Index,Index>> todo;  // rank ranges [l, r) still to report
+    if (L < R) todo.push_back({L, R});
+    while (!todo.empty()) {
+      auto [l, r] = todo.back();
+      todo.pop_back();
+      Index i = prmq.query(prev.data(), l, r - 1);
+      if (prev[i] > L) continue;     // every document in [l, r) is already reported
+      res.push_back(doc[i]);
+      if (i + 1 < r) todo.push_back({i + 1, r});
+      if (l < i) todo.push_back({l, i});
+    }
+    return res;
+  }
+};
+
+using GeneralizedSuffixArray = BasicGeneralizedSuffixArray<uint32_t>;
@@ -0,0 +1,91 @@
+#include "SuffixArray.h"
+#include "BenchUtil.h"
+
+// Build-phase benchmark for SuffixArray, one JSON object per text on stdout.
+//
+//   SuffixArrayBench [max_mb=1024] [threads=0] [seed=1]
+//
+// Texts of 1 MB, 4 MB, ... up to max_mb, each as a uniform random DNA string and as a
+// repetitive one (random 4 KB blocks copied with 1% mutations), where LCPs are long.
+// Phases are timed separately on the same arrays: SA-IS on one and on `threads` threads,
+// inverse SA, Kasai, Phi/PLCP on one and on `threads` threads, block RMQ and (while its
+// n log n words fit under 4 GB) the sparse table. Each text runs in its own child process,
+// so peak_rss_kb covers that text alone.
+
+static string make_text(const string& kind, size_t n, mt19937_64& rng) {
+  string text(n, 0);
+  if (kind == "dna") {
+    for (char& c : text) c = "ACGT"[rng() & 3];
+    return text;
+  }
+  const size_t BLOCK = 4096;
+  string base(BLOCK, 0);
+  for (char& c : base) c = "ACGT"[rng() & 3];
+  for (size_t at = 0; at < n; at += BLOCK) {
+    size_t len = min(BLOCK, n - at);
+    text.replace(at, len, base, 0, len);
+    for (size_t k = 0; k < len / 100; ++k) text[at + rng() % len] = "ACGT"[rng() & 3];
+  }
+  return text;
+}
+
+static void run(const string& kind, size_t bytes, int threads, uint64_t seed) {
+  mt19937_64 rng(seed);
+  string text = make_text(kind, bytes, rng);
+  const uint32_t n = text.size();
+  vector<string> rows;
+  auto row = [&](const char* phase, double ms) {
+    char buf[160];
+    snprintf(buf, sizeof buf, "{\"phase\": \"%s\", \"ms\": %.3f, \"mb_per_s\": %.2f}", phase, ms, n / 1e6 / (ms / 1e3));
+    rows.push_back(buf);
+  };
+
+  SuffixArray A;
+  A.n = n;
+  A.s = vector<char>(text.begin(), text.end());
+  SAIS::ByteText bt{(const unsigned char*)text.data(), text.size()};
+  vector<uint32_t> suf(n + 1);
+  row("sa_is", time_ms([&] { SAIS::sa_is<uint32_t>(bt, n + 1, 257, suf.data(), 1); }));
+  row("sa_is_threads", time_ms([&] { SAIS::sa_is<uint32_t>(bt, n + 1, 257, suf.data(), threads); }));
+  suf.erase(suf.begin());
+  A.sa = move(suf);
+
+  row("inverse_sa", time_ms([&] {
+    vector<uint32_t> rk(n);
+    for (uint32_t i = 0; i < n; ++i) rk[A.sa[i]] = i;
+    A.rankAt = move(rk);
+  }));
+  vector<uint32_t> lcp;
+  row("kasai", time_ms([&] { lcp = A.kasai(); }));
+  A.rankAt = vector<uint32_t>();
+  row("phi", time_ms([&] { A.phi_plcp(1); }));
+  row("phi_threads", time_ms([&] { A.phi_plcp(threads); }));
+  A.lcp = move(lcp);
+
+  A.RMQ_MODE = BLOCK_SPARSE;
+  row("block_rmq", time_ms([&] { A.init_rmq(); }));
+  size_t rmq_bytes = A.brmq.bytes();
+  A.brmq = BlockRMQ<uint32_t>();
+  if ((double)n * (SuffixArray::floor_log2(max<size_t>(n, 2)) + 1) * sizeof(uint32_t) <= 4e9) {
+    A.RMQ_MODE = SPARSE_TABLE;
+    row("sparse_table", time_ms([&] { A.init_rmq(); }));
+  }
+
+  printf("{\"text\": \"%s\", \"bytes\": %u, \"threads\": %d, \"block_rmq_bytes\": %zu, \"peak_rss_kb\": %ld, \"phases\": [",
+         kind.c_str(), n, threads, rmq_bytes, peak_rss_kb());
+  for (size_t i = 0; i < rows.size(); ++i) printf("%s%s", i ? ", " : "", rows[i].c_str());
+  printf("]}\n");
+  fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  double max_mb = argc > 1 ? atof(argv[1]) : 1024;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+  if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+
+  for (double mb = 1; mb <= max_mb; mb *= 4)
+    for (const char* kind : {"dna", "repetitive"})
+      if (!in_child([&] { run(kind, (size_t)(mb * 1e6), threads, seed); }))
+        fprintf(stderr, "%s text of %.0f MB failed\n", kind, mb);
+}
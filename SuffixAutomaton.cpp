@@ -6,128 +6,417 @@
 #include <algorithm>  // For std::min, std::max, std::sort
 #include <queue>        // For BFS in shortest_non_appearing
 #include <limits>     // For std::numeric_limits
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Transition backends for BasicSuffixAutomaton. A backend stores the outgoing edges of
+ * every state and provides:
+ *   accepts(c)           whether c can label an edge, checked before extend() changes anything
+ *   resize(n)            room for states [0, n)
+ *   get(v, c)            target of edge (v, c), -1 if none
+ *   set(v, c, u)         add or redirect edge (v, c)
+ *   copy(from, to)       give state `to` the edges of `from` (cloning)
+ *   for_each(v, f)       f(c, u) for every edge of v, in increasing char order
+ *   bytes()              memory held by the edges
+ */
+
+/**
+ * @brief One std::map per state, the original layout. O(log K) per step.
+ */
+struct MapTransitions {
+    std::vector<std::map<char, int>> next;
+
+    static bool accepts(char) { return true; }
+    void resize(size_t n) { next.resize(n); }
+    int get(int v, char c) const {
+        auto it = next[v].find(c);
+        return it == next[v].end() ? -1 : it->second;
+    }
+    void set(int v, char c, int u) { next[v][c] = u; }
+    void copy(int from, int to) { next[to] = next[from]; }
+    template<class F>
+    void for_each(int v, F&& f) const {
+        for (auto const& [c, u] : next[v]) f(c, u);
+    }
+    size_t bytes() const {
+        size_t edges = 0;
+        for (auto& m : next) edges += m.size();
+        return next.size() * sizeof(std::map<char, int>) + edges * 48; // ~48 bytes per tree node
+    }
+};
+
+/**
+ * @brief A K-entry array per state for bytes [Base, Base + K), e.g. DenseTransitions<26, 'a'>.
+ * O(1) per step, 4K bytes per state; only for small alphabets. Chars are taken as unsigned
+ * bytes, so DenseTransitions<256> orders bytes >= 0x80 after ASCII (std::map puts them
+ * first). extend() on a byte outside the range throws std::out_of_range.
+ */
+template<int K, int Base = 0>
+struct DenseTransitions {
+    std::vector<std::array<int, K>> next;
+
+    static int slot(char c) { return (int)(unsigned char)c - Base; }
+    static bool accepts(char c) { return slot(c) >= 0 && slot(c) < K; }
+    void resize(size_t n) {
+        std::array<int, K> none;
+        none.fill(-1);
+        next.resize(n, none);
+    }
+    int get(int v, char c) const {
+        int k = slot(c);
+        return k >= 0 && k < K ? next[v][k] : -1;
+    }
+    void set(int v, char c, int u) {
+        int k = slot(c);
+        if (k < 0 || k >= K) throw std::out_of_range("DenseTransitions: char outside [Base, Base + K)");
+        next[v][k] = u;
+    }
+    void copy(int from, int to) { next[to] = next[from]; }
+    template<class F>
+    void for_each(int v, F&& f) const {
+        for (int k = 0; k < K; ++k)
+            if (next[v][k] != -1) f((char)(k + Base), next[v][k]);
+    }
+    size_t bytes() const { return next.size() * sizeof(std::array<int, K>); }
+};
+
+/**
+ * @brief Sorted keys and targets per state in one shared arena.
+ * Each state owns a block of power-of-two capacity; a full block moves to one twice as
+ * large and the old one goes on a free list for its size. Blocks of 16 or more keys are
+ * searched 16 at a time with SSE2, smaller ones linearly. About 5 bytes per edge plus
+ * block slack and 8 bytes per state.
+ */
+struct SmallVectorTransitions {
+    struct Slot { uint32_t off = 0; uint16_t size = 0, cap = 0; };
+    std::vector<Slot> slot;
+    std::vector<char> keys;        // arena: keys of a block, sorted
+    std::vector<int> vals;         // arena: targets, parallel to keys
+    std::vector<std::vector<uint32_t>> free_blocks; // free_blocks[k]: free blocks of capacity 2^k
+
+    static bool accepts(char) { return true; }
+    void resize(size_t n) { slot.resize(n); }
+
+    uint32_t alloc(int cap) {
+        int k = __builtin_ctz(cap);
+        if ((int)free_blocks.size() <= k) free_blocks.resize(k + 1);
+        if (!free_blocks[k].empty()) {
+            uint32_t off = free_blocks[k].back();
+            free_blocks[k].pop_back();
+            return off;
+        }
+        uint32_t off = keys.size();
+        keys.resize(off + cap);
+        vals.resize(off + cap);
+        return off;
+    }
+
+    // index of c within v's block, or -1
+    int find(int v, char c) const {
+        const Slot& sl = slot[v];
+        const char* k = keys.data() + sl.off;
+#if defined(__SSE2__)
+        if (sl.cap >= 16) {
+            __m128i needle = _mm_set1_epi8(c);
+            for (int i = 0; i < sl.size; i += 16) {
+                unsigned m = _mm_movemask_epi8(_mm_cmpeq_epi8(needle, _mm_loadu_si128((const __m128i*)(k + i))));
+                if (sl.size - i < 16) m &= (1u << (sl.size - i)) - 1;
+                if (m) return i + __builtin_ctz(m);
+            }
+            return -1;
+        }
+#endif
+        for (int i = 0; i < sl.size; ++i)
+            if (k[i] == c) return i;
+        return -1;
+    }
+
+    int get(int v, char c) const {
+        int i = find(v, c);
+        return i < 0 ? -1 : vals[slot[v].off + i];
+    }
+
+    void set(int v, char c, int u) {
+        int i = find(v, c);
+        if (i >= 0) { vals[slot[v].off + i] = u; return; }
+        if (slot[v].size == slot[v].cap) {
+            int cap = slot[v].cap ? slot[v].cap * 2 : 2;
+            uint32_t off = alloc(cap);   // may move the arena, index it afresh
+            Slot& sl = slot[v];
+            std::copy(keys.begin() + sl.off, keys.begin() + sl.off + sl.size, keys.begin() + off);
+            std::copy(vals.begin() + sl.off, vals.begin() + sl.off + sl.size, vals.begin() + off);
+            if (sl.cap) free_blocks[__builtin_ctz(sl.cap)].push_back(sl.off);
+            sl.off = off;
+            sl.cap = cap;
+        }
+        Slot& sl = slot[v];
+        int at = sl.size;
+        while (at > 0 && keys[sl.off + at - 1] > c) {
+            keys[sl.off + at] = keys[sl.off + at - 1];
+            vals[sl.off + at] = vals[sl.off + at - 1];
+            --at;
+        }
+        keys[sl.off + at] = c;
+        vals[sl.off + at] = u;
+        ++sl.size;
+    }
+
+    void copy(int from, int to) {
+        Slot src = slot[from];
+        Slot& dst = slot[to];
+        if (dst.cap) free_blocks[__builtin_ctz(dst.cap)].push_back(dst.off);
+        dst = Slot();
+        if (!src.size) return;
+        uint32_t off = alloc(src.cap);
+        std::copy(keys.begin() + src.off, keys.begin() + src.off + src.size, keys.begin() + off);
+        std::copy(vals.begin() + src.off, vals.begin() + src.off + src.size, vals.begin() + off);
+        slot[to] = {off, src.size, src.cap};
+    }
+
+    template<class F>
+    void for_each(int v, F&& f) const {
+        const Slot& sl = slot[v];
+        for (int i = 0; i < sl.size; ++i) f(keys[sl.off + i], vals[sl.off + i]);
+    }
+
+    size_t bytes() const {
+        return slot.size() * sizeof(Slot) + keys.size() * (sizeof(char) + sizeof(int));
+    }
+};
+
+/**
+ * @brief All edges in one open-addressing table keyed by (state, char), linear probing,
+ * load factor at most 1/2. for_each probes every char seen so far, in char order.
+ */
+struct HashTransitions {
+    std::vector<uint64_t> keys;    // (state << 8 | byte) + 1, 0 = empty
+    std::vector<int> vals;
+    size_t used = 0;
+    int shift = 64;
+    std::vector<char> alphabet;    // chars on any edge, sorted
+    std::array<bool, 256> seen{};
+
+    HashTransitions() { rehash(16); }
+
+    static bool accepts(char) { return true; }
+
+    static uint64_t key(int v, char c) { return ((uint64_t)v << 8 | (unsigned char)c) + 1; }
+    size_t home(uint64_t k) const { return (k * 0x9E3779B97F4A7C15ULL) >> shift; }
+
+    void rehash(size_t cap) {
+        std::vector<uint64_t> old_keys(cap, 0);
+        std::vector<int> old_vals(cap);
+        keys.swap(old_keys);
+        vals.swap(old_vals);
+        shift = 64 - __builtin_ctzll(cap);
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (!old_keys[i]) continue;
+            size_t h = home(old_keys[i]);
+            while (keys[h]) h = (h + 1) & (keys.size() - 1);
+            keys[h] = old_keys[i];
+            vals[h] = old_vals[i];
+        }
+    }
+
+    void resize(size_t) {}
+
+    int get(int v, char c) const {
+        uint64_t k = key(v, c);
+        for (size_t h = home(k);; h = (h + 1) & (keys.size() - 1)) {
+            if (keys[h] == k) return vals[h];
+            if (!keys[h]) return -1;
+        }
+    }
+
+    void set(int v, char c, int u) {
+        if (2 * (used + 1) > keys.size()) rehash(keys.size() * 2);
+        uint64_t k = key(v, c);
+        size_t h = home(k);
+        while (keys[h] && keys[h] != k) h = (h + 1) & (keys.size() - 1);
+        if (!keys[h]) {
+            keys[h] = k;
+            ++used;
+            if (!seen[(unsigned char)c]) {
+                seen[(unsigned char)c] = true;
+                alphabet.insert(std::upper_bound(alphabet.begin(), alphabet.end(), c), c);
+            }
+        }
+        vals[h] = u;
+    }
+
+    void copy(int from, int to) {
+        for (char c : alphabet) {
+            int u = get(from, c);
+            if (u != -1) set(to, c, u);
+        }
+    }
+
+    template<class F>
+    void for_each(int v, F&& f) const {
+        for (char c : alphabet) {
+            int u = get(v, c);
+            if (u != -1) f(c, u);
+        }
+    }
+
+    size_t bytes() const { return keys.size() * (sizeof(uint64_t) + sizeof(int)); }
+};
 
 /**
  * @brief A contest-ready, expanded Suffix Automaton template.
  * * Implements all applications from cp-algorithms.com.
  * * Time Complexity: Build: O(N * log K) or O(N * K)
  * (O(N * log K) with std::map, O(N * K) with fixed-size array)
+ * * Transitions is one of the backends above; SuffixAutomaton uses SmallVectorTransitions.
+ * * Layout: the core that extend() touches (len, link, clone bit, transitions) is kept in
+ *   parallel arrays. Each application's per-state data lives in its own side array, which
+ *   stays empty until that application is first used.
  */
-struct SuffixAutomaton {
-    
-    /**
-     * @brief Represents a single state in the Suffix Automaton.
-     */
-    struct State {
-        int len;             // Length of the longest substring in this state
-        int link;            // Suffix link to another state
-        std::map<char, int> next; // Transitions on characters
-        
-        // --- Application fields ---
-        
-        /**
-         * For counting occurrences: 1 for non-clones (end positions), 0 for clones.
-         */
-        long long terminal_occurrences = 0; 
-        
-        /**
-         * For counting occurrences: Total occurrences, calculated by DP on suffix link tree.
-         */
-        long long total_occurrences = 0; 
-        
-        /**
-         * For first/all occurrences: Smallest end position of substrings in this state.
-         */
-        int first_pos = -1; 
-        
-        /**
-         * For DP on DAG: Number of distinct non-empty paths starting from this state.
-         */
-        long long distinct_paths = -1; 
-        
-        /**
-         * For DP on DAG: Total length of all distinct non-empty paths starting from this state.
-         */
-        long long total_length = -1;   
-
-        /**
-         * For shortest non-appearing: Length of the shortest path from root to this state.
-         */
-        int shortest_path_len = -1;
-        
-        State() : len(0), link(-1) {}
-    };
+template<class Transitions>
+struct BasicSuffixAutomaton {
+
+    // --- Core, one entry per state ---
+    std::vector<int> len;        // Length of the longest substring in each state
+    std::vector<int> link;       // Suffix link to another state
+    std::vector<bool> is_clone;  // Created by cloning; the others (but the root) end a prefix
+    Transitions next;            // Transitions on characters of every state
 
-    std::vector<State> st; // Vector to store all states
     int sz;                // Current number of states
     int last;              // The state corresponding to the whole string processed so far
     int string_len = 0;    // Original string length
-    std::vector<std::vector<int>> link_tree_adj; // Adjacency list for suffix link tree
-    bool link_tree_built = false;
+
+    // --- Application side arrays, empty until first needed ---
+
+    /**
+     * For counting occurrences: Total occurrences, calculated by DP on suffix link tree.
+     */
+    std::vector<long long> total_occurrences;
+
+    /**
+     * For first/all occurrences: Smallest end position of substrings in each state.
+     */
+    std::vector<int> first_pos;
+
+    /**
+     * For DP on DAG: Number of distinct non-empty paths starting from each state.
+     */
+    std::vector<long long> distinct_paths;
+
+    /**
+     * For DP on DAG: Total length of all distinct non-empty paths starting from each state.
+     */
+    std::vector<long long> total_length;
+
+    /**
+     * For shortest non-appearing: Length of the shortest path from root to each state.
+     */
+    std::vector<int> shortest_path_len;
+
+    /**
+     * States by decreasing len: children before their suffix link, transition targets
+     * before their sources. Every DP below is one sequential pass over it.
+     */
+    std::vector<int> len_order;
+
+    /**
+     * For all occurrences: the end positions in suffix-link-tree preorder, so the end
+     * positions of state v are end_pos[occ_begin[v] .. occ_begin[v] + total_occurrences[v]).
+     */
+    std::vector<int> occ_begin;
+    std::vector<int> end_pos;
+
+    /**
+     * @brief For counting occurrences: 1 for non-clones (end positions), 0 for clones and root.
+     */
+    int terminal_occurrences(int v) const {
+        return v != 0 && !is_clone[v];
+    }
+
+    /**
+     * @brief Appends a state and returns its id.
+     */
+    int new_state(int l, int lk, bool clone) {
+        len.push_back(l);
+        link.push_back(lk);
+        is_clone.push_back(clone);
+        next.resize(len.size());
+        return sz++;
+    }
+
+    /**
+     * @brief Drops every side array, they no longer match the automaton.
+     */
+    void clear_side_arrays() {
+        total_occurrences.clear();
+        first_pos.clear();
+        distinct_paths.clear();
+        total_length.clear();
+        shortest_path_len.clear();
+        len_order.clear();
+        occ_begin.clear();
+        end_pos.clear();
+    }
 
     /**
      * @brief Initializes the Suffix Automaton.
      */
     void init() {
-        st.clear();
-        st.resize(2); // Start with 2 to avoid resizing on first extend
-        st[0].len = 0;
-        st[0].link = -1;
-        st[0].shortest_path_len = 0;
-        sz = 1;
+        len.clear();
+        link.clear();
+        is_clone.clear();
+        next = Transitions();
+        sz = 0;
+        new_state(0, -1, false);
         last = 0;
         string_len = 0;
-        link_tree_built = false;
-        link_tree_adj.clear();
+        clear_side_arrays();
     }
 
     /**
      * @brief Default constructor.
      */
-    SuffixAutomaton() {
+    BasicSuffixAutomaton() {
         init();
     }
 
     /**
      * @brief Extends the automaton by adding a single character 'c'.
+     * Throws std::out_of_range, leaving the automaton unchanged, if the backend cannot store c.
      */
     void extend(char c) {
-        // Ensure capacity if needed
-        if (sz >= st.size()) {
-            st.resize(st.size() * 2);
-        }
+        if (!Transitions::accepts(c))
+            throw std::out_of_range("SuffixAutomaton: char not supported by the transition backend");
+        clear_side_arrays();
+        string_len++;
+        int cur = new_state(len[last] + 1, -1, false); // Non-clones are end-positions
 
-        int cur = sz++;
-        st[cur].len = st[last].len + 1;
-        st[cur].terminal_occurrences = 1; // Mark as end-position
-        st[cur].first_pos = st[cur].len - 1; // First end pos is its own length
-        
         int p = last;
 
-        while (p != -1 && !st[p].next.count(c)) {
-            st[p].next[c] = cur;
-            p = st[p].link;
+        while (p != -1 && next.get(p, c) == -1) {
+            next.set(p, c, cur);
+            p = link[p];
         }
 
         if (p == -1) {
-            st[cur].link = 0;
+            link[cur] = 0;
         } else {
-            int q = st[p].next[c];
-            if (st[p].len + 1 == st[q].len) {
-                st[cur].link = q;
+            int q = next.get(p, c);
+            if (len[p] + 1 == len[q]) {
+                link[cur] = q;
             } else {
-                int clone = sz++;
-                if (sz >= st.size()) st.resize(st.size() * 2);
-
-                st[clone] = st[q]; // Copy transitions, link, and first_pos
-                st[clone].len = st[p].len + 1;
-                st[clone].terminal_occurrences = 0; // Clones are not terminal
-                
-                while (p != -1 && st[p].next.count(c) && st[p].next[c] == q) {
-                    st[p].next[c] = clone;
-                    p = st[p].link;
+                int clone = new_state(len[p] + 1, link[q], true); // Clones are not terminal
+                next.copy(q, clone); // Copy transitions
+
+                while (p != -1 && next.get(p, c) == q) {
+                    next.set(p, c, clone);
+                    p = link[p];
                 }
-                st[q].link = st[cur].link = clone;
+                link[q] = link[cur] = clone;
             }
         }
         last = cur;
@@ -138,42 +427,32 @@ struct SuffixAutomaton {
      */
     void build(const std::string& s) {
         init();
-        st.reserve(s.length() * 2 + 2); // Pre-allocate memory
-        string_len = s.length();
+        len.reserve(s.length() * 2 + 2); // Pre-allocate memory
+        link.reserve(s.length() * 2 + 2);
+        is_clone.reserve(s.length() * 2 + 2);
         for (char c : s) {
             extend(c);
         }
     }
 
     /**
-     * @brief Helper to get states sorted by length (for DP on link tree).
+     * @brief Helper to get states sorted by decreasing length (for DPs on the link tree
+     * and the DAG). Counting sort on len, computed once until the next extend.
      */
-    std::vector<int> get_states_by_len_order() {
-        std::vector<std::vector<int>> states_by_len(string_len + 1);
+    const std::vector<int>& get_states_by_len_order() {
+        if (!len_order.empty()) return len_order;
+        std::vector<int> cnt(string_len + 2, 0);
         for (int v = 0; v < sz; ++v) {
-            states_by_len[st[v].len].push_back(v);
+            cnt[string_len - len[v] + 1]++;
         }
-        
-        std::vector<int> sorted_states;
-        sorted_states.reserve(sz);
-        for (int l = string_len; l >= 0; --l) {
-            for (int v : states_by_len[l]) {
-                sorted_states.push_back(v);
-            }
+        for (int l = 1; l <= string_len + 1; ++l) {
+            cnt[l] += cnt[l - 1];
         }
-        return sorted_states;
-    }
-
-    /**
-     * @brief Builds the adjacency list for the suffix link tree.
-     */
-    void build_suffix_link_tree() {
-        if (link_tree_built) return;
-        link_tree_adj.resize(sz);
-        for (int v = 1; v < sz; ++v) {
-            link_tree_adj[st[v].link].push_back(v);
+        len_order.resize(sz);
+        for (int v = 0; v < sz; ++v) {
+            len_order[cnt[string_len - len[v]]++] = v;
         }
-        link_tree_built = true;
+        return len_order;
     }
     
     /**
@@ -183,28 +462,28 @@ struct SuffixAutomaton {
     int find_state(const std::string& p) {
         int cur = 0;
         for (char c : p) {
-            if (!st[cur].next.count(c)) {
+            cur = next.get(cur, c);
+            if (cur == -1) {
                 return -1;
             }
-            cur = st[cur].next[c];
         }
         return cur;
     }
     
     /**
-     * @brief Recursive DP to calculate paths and total length on the DAG.
-     * Fills `distinct_paths` and `total_length` for all states.
+     * @brief DP to calculate paths and total length on the DAG.
+     * Fills `distinct_paths` and `total_length` for all states, once.
      */
-    void dfs_dag_dps(int u) {
-        if (st[u].distinct_paths != -1) return;
-
-        st[u].distinct_paths = 0; // non-empty paths
-        st[u].total_length = 0;
-
-        for (auto const& [key, v] : st[u].next) {
-            dfs_dag_dps(v);
-            st[u].distinct_paths += (1 + st[v].distinct_paths);
-            st[u].total_length += (1 + st[v].distinct_paths) + st[v].total_length;
+    void calculate_paths() {
+        if (!distinct_paths.empty()) return;
+        distinct_paths.assign(sz, 0); // non-empty paths
+        total_length.assign(sz, 0);
+
+        for (int u : get_states_by_len_order()) { // Targets are longer, so already done
+            next.for_each(u, [&](char, int v) {
+                distinct_paths[u] += (1 + distinct_paths[v]);
+                total_length[u] += (1 + distinct_paths[v]) + total_length[v];
+            });
         }
     }
 
@@ -223,7 +502,7 @@ struct SuffixAutomaton {
     long long count_distinct_substrings() {
         long long total = 0;
         for (int v = 1; v < sz; ++v) {
-            total += (st[v].len - st[st[v].link].len);
+            total += (len[v] - len[link[v]]);
         }
         return total;
     }
@@ -233,13 +512,8 @@ struct SuffixAutomaton {
      * @brief Calculates the total length of all distinct substrings.
      */
     long long total_length_distinct_substrings() {
-        // Clear old DP state
-        for (int i = 0; i < sz; ++i) {
-            st[i].distinct_paths = -1;
-            st[i].total_length = -1;
-        }
-        dfs_dag_dps(0);
-        return st[0].total_length;
+        calculate_paths();
+        return total_length[0];
     }
 
     // --- APPLICATION 4: Lexicographically k-th substring ---
@@ -250,30 +524,26 @@ struct SuffixAutomaton {
      */
     std::string find_kth_substring(long long k) {
         // Ensure DP is calculated
-        if (st[0].distinct_paths == -1) {
-            for (int i = 0; i < sz; ++i) {
-                st[i].distinct_paths = -1;
-                st[i].total_length = -1;
-            }
-            dfs_dag_dps(0);
-        }
+        calculate_paths();
 
-        if (k > st[0].distinct_paths) return ""; // k is too large
+        if (k > distinct_paths[0]) return ""; // k is too large
 
         std::string result = "";
         int u = 0;
         while (k > 0) {
-            for (auto const& [key, v] : st[u].next) {
-                long long paths_from_v = 1 + st[v].distinct_paths;
+            int to = -1;
+            next.for_each(u, [&](char key, int v) {
+                if (to != -1) return;
+                long long paths_from_v = 1 + distinct_paths[v];
                 if (k <= paths_from_v) {
                     result.push_back(key);
-                    u = v;
+                    to = v;
                     k--; // Account for the 1-char path
-                    break;
                 } else {
                     k -= paths_from_v;
                 }
-            }
+            });
+            u = to;
         }
         return result;
     }
@@ -286,7 +556,7 @@ struct SuffixAutomaton {
     static std::string find_smallest_cyclic_shift(const std::string& s) {
         if (s.empty()) return "";
         
-        SuffixAutomaton sam_double;
+        BasicSuffixAutomaton sam_double;
         sam_double.build(s + s);
         
         int n = s.length();
@@ -294,52 +564,68 @@ struct SuffixAutomaton {
         std::string result = "";
         
         for (int i = 0; i < n; i++) {
-            if (sam_double.st[u].next.empty()) {
+            int to = -1;
+            // Backends iterate in alphabetical order, the first edge is the smallest
+            sam_double.next.for_each(u, [&](char c, int v) {
+                if (to != -1) return;
+                result.push_back(c);
+                to = v;
+            });
+            if (to == -1) {
                 // Should not happen if s is not empty
-                break; 
+                break;
             }
-            // `std::map` guarantees iteration in alphabetical order
-            auto it = sam_double.st[u].next.begin();
-            result.push_back(it->first);
-            u = it->second;
+            u = to;
         }
         return result;
     }
 
     // --- APPLICATION 6: Number of occurrences ---
     /**
-     * @brief Calculates `total_occurrences` for all states.
-     * Must be called before `get_occurrences`.
+     * @brief Calculates `total_occurrences` for all states, once.
+     * `get_occurrences` calls it when needed.
      */
     void calculate_occurrences() {
-        auto sorted_states = get_states_by_len_order();
+        if (!total_occurrences.empty()) return;
+        const std::vector<int>& sorted_states = get_states_by_len_order();
         
-        for (int v : sorted_states) {
+        total_occurrences.resize(sz);
+        for (int v = 0; v < sz; ++v) {
             // Initialize total_occurrences with terminal_occurrences
-            if (st[v].terminal_occurrences == 1) {
-                st[v].total_occurrences = st[v].terminal_occurrences;
-            } else {
-                st[v].total_occurrences = 0;
-            }
+            total_occurrences[v] = terminal_occurrences(v);
         }
         
         for (int v : sorted_states) {
-            if (st[v].link != -1) {
-                st[st[v].link].total_occurrences += st[v].total_occurrences;
+            if (link[v] != -1) {
+                total_occurrences[link[v]] += total_occurrences[v];
             }
         }
     }
 
     /**
      * @brief Finds the number of occurrences of a pattern 'p'.
-     * Must call `calculate_occurrences()` *before* using this.
      */
     long long get_occurrences(const std::string& p) {
+        calculate_occurrences();
         int v = find_state(p);
-        return (v == -1) ? 0 : st[v].total_occurrences;
+        return (v == -1) ? 0 : total_occurrences[v];
     }
 
     // --- APPLICATION 7: First occurrence position ---
+    /**
+     * @brief Calculates `first_pos` for all states: a non-clone ends first at len - 1,
+     * any other state at the smallest first_pos in its suffix link subtree.
+     */
+    void calculate_first_pos() {
+        if (!first_pos.empty()) return;
+        first_pos.assign(sz, std::numeric_limits<int>::max());
+        for (int v : get_states_by_len_order()) {
+            if (terminal_occurrences(v)) first_pos[v] = std::min(first_pos[v], len[v] - 1);
+            if (link[v] != -1) first_pos[link[v]] = std::min(first_pos[link[v]], first_pos[v]);
+        }
+        first_pos[0] = -1;
+    }
+
     /**
      * @brief Finds the 0-indexed start position of the first occurrence of 'p'.
      * @return Start index, or -1 if not found.
@@ -347,34 +633,65 @@ struct SuffixAutomaton {
     int get_first_occurrence(const std::string& p) {
         int v = find_state(p);
         if (v == -1) return -1;
-        return st[v].first_pos - p.length() + 1;
+        calculate_first_pos();
+        return first_pos[v] - p.length() + 1;
     }
 
     // --- APPLICATION 8: All occurrence positions ---
     /**
-     * @brief Helper to find all end positions in the subtree of the link tree.
+     * @brief Read-only view of a slice of `end_pos`.
      */
-    void dfs_all_occurrences(int u, std::vector<int>& results) {
-        if (st[u].terminal_occurrences == 1) {
-            results.push_back(st[u].first_pos);
-        }
-        for (int v : link_tree_adj[u]) {
-            dfs_all_occurrences(v, results);
+    struct EndPositions {
+        const int* first = nullptr;
+        const int* last = nullptr;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    /**
+     * @brief Lays out `end_pos` so every state's end positions are contiguous (the
+     * Euler tour of the suffix link tree). In increasing len order each state takes the
+     * next total_occurrences[v] slots of its parent's slice, its own end position first.
+     */
+    void calculate_end_positions() {
+        if (!end_pos.empty() || sz == 1) return;
+        calculate_occurrences();
+        const std::vector<int>& order = get_states_by_len_order();
+        occ_begin.assign(sz, 0);
+        end_pos.assign(total_occurrences[0], 0);
+        std::vector<int> fill(sz, 0); // Next free slot in each state's slice
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int v = *it;
+            if (v != 0) {
+                occ_begin[v] = fill[link[v]];
+                fill[link[v]] += total_occurrences[v];
+            }
+            fill[v] = occ_begin[v];
+            if (terminal_occurrences(v) == 1) {
+                end_pos[fill[v]++] = len[v] - 1; // A non-clone's only new end position
+            }
         }
     }
 
+    /**
+     * @brief End positions of every occurrence of 'p', unordered, in O(|p|) and without
+     * copying; start = end - |p| + 1. Valid until the next extend.
+     */
+    EndPositions occurrence_span(const std::string& p) {
+        int v = find_state(p);
+        if (v == -1 || sz == 1) return {};
+        calculate_end_positions();
+        const int* first = end_pos.data() + occ_begin[v];
+        return {first, first + total_occurrences[v]};
+    }
+
     /**
      * @brief Finds all 0-indexed start positions of a pattern 'p'.
      * @return A sorted vector of start positions.
      */
     std::vector<int> get_all_occurrences(const std::string& p) {
-        int v = find_state(p);
-        if (v == -1) return {};
-
-        build_suffix_link_tree();
-        
-        std::vector<int> end_positions;
-        dfs_all_occurrences(v, end_positions);
+        EndPositions end_positions = occurrence_span(p);
         
         std::vector<int> start_positions;
         start_positions.reserve(end_positions.size());
@@ -392,9 +709,8 @@ struct SuffixAutomaton {
      * @param alphabet The alphabet to consider.
      */
     std::string find_shortest_non_appearing(std::string alphabet = "abcdefghijklmnopqrstuvwxyz") {
-        if (st[0].shortest_path_len == -1) { // Re-init if needed
-             st[0].shortest_path_len = 0;
-        }
+        shortest_path_len.assign(sz, -1);
+        shortest_path_len[0] = 0;
 
         std::queue<int> q;
         q.push(0);
@@ -408,13 +724,13 @@ struct SuffixAutomaton {
             path = path_q.front(); path_q.pop();
 
             for (char c : alphabet) {
-                if (!st[u].next.count(c)) {
+                int v = next.get(u, c);
+                if (v == -1) {
                     return path + c; // Found it
                 } else {
-                    int v = st[u].next[c];
                     // Use shortest_path_len as a 'visited' flag for BFS
-                    if (st[v].shortest_path_len == -1) { 
-                        st[v].shortest_path_len = st[u].shortest_path_len + 1;
+                    if (shortest_path_len[v] == -1) { 
+                        shortest_path_len[v] = shortest_path_len[u] + 1;
                         q.push(v);
                         path_q.push(path + c);
                     }
@@ -430,7 +746,7 @@ struct SuffixAutomaton {
      * This is a static method.
      */
     static std::string lcs(const std::string& s1, const std::string& s2) {
-        SuffixAutomaton sa;
+        BasicSuffixAutomaton sa;
         sa.build(s1);
 
         int l = 0, max_l = 0, best_pos = -1;
@@ -438,12 +754,12 @@ struct SuffixAutomaton {
 
         for (int i = 0; i < s2.length(); i++) {
             char c = s2[i];
-            while (cur != 0 && !sa.st[cur].next.count(c)) {
-                cur = sa.st[cur].link;
-                l = sa.st[cur].len;
+            while (cur != 0 && sa.next.get(cur, c) == -1) {
+                cur = sa.link[cur];
+                l = sa.len[cur];
             }
-            if (sa.st[cur].next.count(c)) {
-                cur = sa.st[cur].next[c];
+            if (sa.next.get(cur, c) != -1) {
+                cur = sa.next.get(cur, c);
                 l++;
             }
             if (l > max_l) {
@@ -464,25 +780,25 @@ struct SuffixAutomaton {
         if (strings.empty()) return 0;
 
         // Build automaton on the first string
-        SuffixAutomaton sa;
+        BasicSuffixAutomaton sa;
         sa.build(strings[0]);
         
         std::vector<int> min_lcs_for_state(sa.sz);
-        for(int v=0; v<sa.sz; ++v) min_lcs_for_state[v] = sa.st[v].len;
+        for(int v=0; v<sa.sz; ++v) min_lcs_for_state[v] = sa.len[v];
 
-        auto sorted_states = sa.get_states_by_len_order();
+        const std::vector<int>& sorted_states = sa.get_states_by_len_order();
 
         for (size_t i = 1; i < strings.size(); ++i) {
             std::vector<int> current_lcs(sa.sz, 0);
             int l = 0, cur = 0;
 
             for (char c : strings[i]) {
-                while (cur != 0 && !sa.st[cur].next.count(c)) {
-                    cur = sa.st[cur].link;
-                    l = sa.st[cur].len;
+                while (cur != 0 && sa.next.get(cur, c) == -1) {
+                    cur = sa.link[cur];
+                    l = sa.len[cur];
                 }
-                if (sa.st[cur].next.count(c)) {
-                    cur = sa.st[cur].next[c];
+                if (sa.next.get(cur, c) != -1) {
+                    cur = sa.next.get(cur, c);
                     l++;
                 }
                 current_lcs[cur] = std::max(current_lcs[cur], l);
@@ -490,10 +806,10 @@ struct SuffixAutomaton {
 
             // Propagate matches up the suffix link tree
             for (int v : sorted_states) {
-                if (sa.st[v].link != -1) {
-                    current_lcs[sa.st[v].link] = std::max(
-                        current_lcs[sa.st[v].link],
-                        std::min(current_lcs[v], sa.st[sa.st[v].link].len)
+                if (sa.link[v] != -1) {
+                    current_lcs[sa.link[v]] = std::max(
+                        current_lcs[sa.link[v]],
+                        std::min(current_lcs[v], sa.len[sa.link[v]])
                     );
                 }
             }
@@ -514,6 +830,8 @@ struct SuffixAutomaton {
 
 };
 
+using SuffixAutomaton = BasicSuffixAutomaton<SmallVectorTransitions>;
+
 // --- Example Usage ---
 int main() {
     std::string s = "ababa";